@@ -0,0 +1,331 @@
+/**
+ * @file AutomatonSimulator.cpp
+ * @brief Implementation of AutomatonSimulator functions.
+ * @author Ankit Srivastava <asrivast@gatech.edu>
+ *
+ * Copyright 2018 Georgia Institute of Technology
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "AutomatonSimulator.hpp"
+
+#include "LabelingAlgorithms.hpp"
+
+#include <algorithm>
+
+
+/**
+ * @brief  Class for storing the labels of a comparator macro as ranges of symbols.
+ *
+ * @tparam LimitType  Datatype of the limits of the programmed intervals.
+ */
+template <typename LimitType>
+class AutomatonSimulator<LimitType>::Labels {
+public:
+  /**
+   * @brief  Constructor for labeling the given comparator. All the STEs are initialized to match no symbols.
+   *
+   * @param ranges  Symbol ranges of all the parameters of the comparator.
+   */
+  Labels(
+    std::array<SymbolRanges, P>& ranges
+  ) : m_ranges(ranges)
+  {
+    SymbolRanges empty = {{1, 0, 1, 0}};
+    m_ranges.fill(empty);
+  }
+
+  void
+  add(
+    const unsigned param,
+    const unsigned char symbol
+  )
+  {
+    m_ranges[param][0] = symbol;
+    m_ranges[param][1] = symbol;
+  }
+
+  void
+  add(
+    const unsigned param,
+    const std::pair<unsigned char, bool> lower,
+    const std::pair<unsigned char, bool> upper
+  )
+  {
+    setRange(param, 0, lower, upper);
+  }
+
+  void
+  add(
+    const unsigned param,
+    const std::vector<std::pair<std::pair<unsigned char, bool>, std::pair<unsigned char, bool> > >& intervals
+  )
+  {
+    for (size_t r = 0; (r < intervals.size()) && (r < 2); ++r) {
+      setRange(param, r, intervals[r].first, intervals[r].second);
+    }
+  }
+
+private:
+  /**
+   * @brief  Function for setting a range of the given parameter, using the same limits as getIntervalSymbols.
+   */
+  void
+  setRange(
+    const unsigned param,
+    const size_t r,
+    const std::pair<unsigned char, bool> lower,
+    const std::pair<unsigned char, bool> upper
+  )
+  {
+    if (((lower.first == 255) && !lower.second) || ((upper.first == 0) && !upper.second)) {
+      return;
+    }
+    m_ranges[param][2*r] = lower.first + (lower.second ? 0 : 1);
+    m_ranges[param][2*r+1] = upper.first - (upper.second ? 0 : 1);
+  }
+
+private:
+  std::array<SymbolRanges, P>& m_ranges;
+}; // class AutomatonSimulator<LimitType>::Labels
+
+/**
+ * @brief  Default constructor for a simulator without any comparators.
+ *
+ * @tparam LimitType  Datatype of the limits of the programmed intervals.
+ */
+template <typename LimitType>
+AutomatonSimulator<LimitType>::AutomatonSimulator(
+) : m_elementRefs(),
+    m_labels()
+{
+}
+
+/**
+ * @brief  Function for programming an interval on a new comparator.
+ *
+ * @tparam LimitType  Datatype of the limits of the programmed intervals.
+ * @param elementRef  Reference of the macro to be reported for the comparator.
+ * @param x           Byte representation of the lower limit of the interval.
+ * @param y           Byte representation of the upper limit of the interval.
+ */
+template <typename LimitType>
+void
+AutomatonSimulator<LimitType>::program(
+  const ap::ElementRef& elementRef,
+  const unsigned char* const x,
+  const unsigned char* const y
+)
+{
+  m_elementRefs.push_back(elementRef);
+  m_labels.push_back(std::array<SymbolRanges, P>());
+  Labels labels(m_labels.back());
+  assignLabels<LimitType>(x, y, labels);
+}
+
+/**
+ * @brief  Function for adding a disabled comparator, on which an interval can be programmed later.
+ *
+ * @tparam LimitType  Datatype of the limits of the programmed intervals.
+ * @param elementRef  Reference of the macro to be reported for the comparator.
+ */
+template <typename LimitType>
+void
+AutomatonSimulator<LimitType>::program(
+  const ap::ElementRef& elementRef
+)
+{
+  m_elementRefs.push_back(elementRef);
+  m_labels.push_back(std::array<SymbolRanges, P>());
+  // None of the STEs match any symbols after the labels are constructed.
+  Labels labels(m_labels.back());
+}
+
+/**
+ * @brief  Function for programming an interval on an existing comparator.
+ *
+ * @tparam LimitType  Datatype of the limits of the programmed intervals.
+ * @param comparator  Index of the comparator, in the order of programming.
+ * @param x           Byte representation of the lower limit of the interval.
+ * @param y           Byte representation of the upper limit of the interval.
+ */
+template <typename LimitType>
+void
+AutomatonSimulator<LimitType>::reprogram(
+  const size_t comparator,
+  const unsigned char* const x,
+  const unsigned char* const y
+)
+{
+  Labels labels(m_labels[comparator]);
+  assignLabels<LimitType>(x, y, labels);
+}
+
+/**
+ * @brief  Function for disabling an existing comparator, so that it never reports.
+ *
+ * @tparam LimitType  Datatype of the limits of the programmed intervals.
+ * @param comparator  Index of the comparator, in the order of programming.
+ */
+template <typename LimitType>
+void
+AutomatonSimulator<LimitType>::disable(
+  const size_t comparator
+)
+{
+  // None of the STEs match any symbols after the labels are constructed.
+  Labels labels(m_labels[comparator]);
+}
+
+/**
+ * @brief  Function for getting the number of programmed comparators.
+ *
+ * @tparam LimitType  Datatype of the limits of the programmed intervals.
+ *
+ * @return  The number of comparators.
+ */
+template <typename LimitType>
+size_t
+AutomatonSimulator<LimitType>::count(
+) const
+{
+  return m_labels.size();
+}
+
+/**
+ * @brief  Function for building the symbol tables for a block of comparators.
+ *
+ * @tparam LimitType  Datatype of the limits of the programmed intervals.
+ * @param first       Index of the first comparator in the block.
+ * @param last        Index one past the last comparator in the block.
+ * @param tables      Bit vectors of the comparators, for every parameter and symbol, whose STE matches the symbol.
+ */
+template <typename LimitType>
+void
+AutomatonSimulator<LimitType>::buildTables(
+  const size_t first,
+  const size_t last,
+  std::vector<uint64_t>& tables
+) const
+{
+  std::fill(tables.begin(), tables.end(), 0);
+  for (size_t c = first; c < last; ++c) {
+    const size_t word = (c - first) / 64;
+    const uint64_t bit = static_cast<uint64_t>(1) << ((c - first) % 64);
+    for (unsigned p = 1; p < P; ++p) {
+      const SymbolRanges& ranges = m_labels[c][p];
+      for (unsigned r = 0; r < 2; ++r) {
+        for (unsigned s = ranges[2*r]; s <= ranges[2*r+1]; ++s) {
+          tables[((p * 256) + s) * BlockWords + word] |= bit;
+        }
+      }
+    }
+  }
+}
+
+/**
+ * @brief  Function for streaming the given symbols through all the comparators.
+ *
+ * @tparam LimitType  Datatype of the limits of the programmed intervals.
+ * @param stream      Byte stream of big-endian points.
+ *
+ * @return  Pairs of offset and macro reference, in the order of the offsets, for all the reports.
+ *
+ * Similar to the device, the offset of a report is the number of symbols processed when the report was generated.
+ * The flows are never split on the simulator and therefore, the chunk size is ignored.
+ */
+template <typename LimitType>
+std::vector<std::pair<size_t, ap::ElementRef> >
+AutomatonSimulator<LimitType>::search(
+  const std::vector<unsigned char>& stream,
+  const size_t
+) const
+{
+  std::vector<std::pair<size_t, ap::ElementRef> > reports;
+  const size_t numPoints = stream.size() / B;
+  std::vector<uint64_t> tables(P * 256 * BlockWords);
+  // STE activation bit vectors for the lower limit chain, the upper limit chain,
+  // and the chain of STEs which accept all the remaining symbols of a point.
+  std::array<uint64_t, BlockWords> lower, upper, accept;
+  for (size_t first = 0; first < m_labels.size(); first += BlockWords * 64) {
+    const size_t last = std::min(first + BlockWords * 64, m_labels.size());
+    const size_t words = ((last - first) + 63) / 64;
+    buildTables(first, last, tables);
+    const unsigned char* symbol = stream.data();
+    for (size_t n = 0; n < numPoints; ++n, symbol += B) {
+      // Start STEs are enabled on the first symbol of every point.
+      const uint64_t* x = &tables[((1 * 256) + symbol[0]) * BlockWords];
+      const uint64_t* between = &tables[((2 * 256) + symbol[0]) * BlockWords];
+      const uint64_t* y = &tables[((4 * 256) + symbol[0]) * BlockWords];
+      uint64_t active = 0;
+      for (size_t w = 0; w < words; ++w) {
+        lower[w] = x[w];
+        upper[w] = y[w];
+        accept[w] = between[w];
+        active |= lower[w] | upper[w] | accept[w];
+      }
+      for (unsigned i = 1; (i < (B-1)) && (active != 0); ++i) {
+        x = &tables[(((4*i+1) * 256) + symbol[i]) * BlockWords];
+        const uint64_t* greater = &tables[(((4*i+2) * 256) + symbol[i]) * BlockWords];
+        const uint64_t* smaller = &tables[(((4*i+3) * 256) + symbol[i]) * BlockWords];
+        y = &tables[(((4*i+4) * 256) + symbol[i]) * BlockWords];
+        active = 0;
+        for (size_t w = 0; w < words; ++w) {
+          accept[w] |= (lower[w] & greater[w]) | (upper[w] & smaller[w]);
+          lower[w] &= x[w];
+          upper[w] &= y[w];
+          active |= lower[w] | upper[w] | accept[w];
+        }
+      }
+      if (active == 0) {
+        continue;
+      }
+      // Report STEs on the last symbol of the point.
+      const uint64_t* greater = &tables[(((4*(B-1)+2) * 256) + symbol[B-1]) * BlockWords];
+      const uint64_t* smaller = &tables[(((4*(B-1)+3) * 256) + symbol[B-1]) * BlockWords];
+      const size_t offset = (n + 1) * B;
+      for (size_t w = 0; w < words; ++w) {
+        uint64_t report = accept[w] | (lower[w] & greater[w]) | (upper[w] & smaller[w]);
+        while (report != 0) {
+          const size_t c = first + (w * 64) + __builtin_ctzll(report);
+          reports.push_back(std::make_pair(offset, m_elementRefs[c]));
+          report &= report - 1;
+        }
+      }
+    }
+  }
+  // Order the reports by offset, as generated by the device.
+  std::stable_sort(reports.begin(), reports.end(),
+                   [](const std::pair<size_t, ap::ElementRef>& a, const std::pair<size_t, ap::ElementRef>& b)
+                   { return a.first < b.first; });
+  return reports;
+}
+
+/**
+ * @brief  Default destructor.
+ *
+ * @tparam LimitType  Datatype of the limits of the programmed intervals.
+ */
+template <typename LimitType>
+AutomatonSimulator<LimitType>::~AutomatonSimulator(
+)
+{
+}
+
+// Explicit class instantiation.
+template class AutomatonSimulator<uint32_t>;
+template class AutomatonSimulator<int32_t>;
+template class AutomatonSimulator<uint64_t>;
+template class AutomatonSimulator<int64_t>;
+template class AutomatonSimulator<float>;
+template class AutomatonSimulator<double>;
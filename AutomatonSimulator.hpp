@@ -0,0 +1,85 @@
+/**
+ * @file AutomatonSimulator.hpp
+ * @brief Declaration of AutomatonSimulator functions.
+ * @author Ankit Srivastava <asrivast@gatech.edu>
+ *
+ * Copyright 2018 Georgia Institute of Technology
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef AUTOMATONSIMULATOR_HPP_
+#define AUTOMATONSIMULATOR_HPP_
+
+#include "apsdk/Automaton.hpp"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+
+/**
+ * @brief  Class for simulating the comparator automaton on the CPU, in place of the AP device.
+ *
+ * @tparam LimitType  Datatype of the limits of the programmed intervals.
+ *
+ * The activation states of the STEs of all the comparators are stored as bit vectors,
+ * one bit per comparator, so that every symbol is processed by 64 comparators at a time.
+ */
+template <typename LimitType>
+class AutomatonSimulator {
+public:
+  AutomatonSimulator();
+
+  void
+  program(const ap::ElementRef&, const unsigned char* const, const unsigned char* const);
+
+  void
+  program(const ap::ElementRef&);
+
+  void
+  reprogram(const size_t, const unsigned char* const, const unsigned char* const);
+
+  void
+  disable(const size_t);
+
+  size_t
+  count() const;
+
+  std::vector<std::pair<size_t, ap::ElementRef> >
+  search(const std::vector<unsigned char>&, const size_t) const;
+
+  ~AutomatonSimulator();
+
+private:
+  static const unsigned B = sizeof(LimitType);
+  // Number of parameters in a comparator macro, i.e., %p1 to %p(4B-1).
+  static const unsigned P = 4*B;
+  // Number of 64-bit words of comparators which are simulated together.
+  static const size_t BlockWords = 64;
+
+private:
+  // Symbol set of an STE stored as two inclusive ranges of symbols.
+  typedef std::array<unsigned char, 4> SymbolRanges;
+
+  class Labels;
+
+private:
+  void
+  buildTables(const size_t, const size_t, std::vector<uint64_t>&) const;
+
+private:
+  std::vector<ap::ElementRef> m_elementRefs;
+  std::vector<std::array<SymbolRanges, P> > m_labels;
+};
+
+#endif // AUTOMATONSIMULATOR_HPP_
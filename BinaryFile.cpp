@@ -0,0 +1,232 @@
+/**
+ * @file BinaryFile.cpp
+ * @brief Implementation of BinaryFile functions.
+ * @author Ankit Srivastava <asrivast@gatech.edu>
+ *
+ * Copyright 2018 Georgia Institute of Technology
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "BinaryFile.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+/**
+ * @brief  Header of the binary files.
+ */
+struct BinaryHeader {
+  char magic[8];
+  uint32_t type;
+  uint32_t arity;
+  uint64_t count;
+  uint64_t reserved;
+};
+
+static_assert(sizeof(BinaryHeader) == 32, "Unexpected size of the binary header.");
+
+static const char BinaryMagic[8] = {'S', 'T', 'A', 'B', 'B', 'I', 'N', '1'};
+
+/**
+ * @brief  Function for checking that the host stores numbers in little-endian byte order.
+ */
+static
+void
+checkLittleEndian(
+)
+{
+  const uint16_t probe = 1;
+  if (*reinterpret_cast<const unsigned char*>(&probe) != 1) {
+    throw std::runtime_error("Binary files are supported only on little-endian hosts.");
+  }
+}
+
+/**
+ * @brief  Constructor for memory mapping the given binary file.
+ *
+ * @param fileName  Name of the binary file.
+ * @param type      Expected type of the values in the file.
+ * @param arity     Expected number of values in every record.
+ */
+BinaryFile::BinaryFile(
+  const std::string& fileName,
+  const uint32_t type,
+  const uint32_t arity
+) : m_address(MAP_FAILED),
+    m_size(0),
+    m_count(0)
+{
+  checkLittleEndian();
+  int fd = open(fileName.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::runtime_error("Couldn't open the binary file " + fileName + ".");
+  }
+  struct stat status;
+  if ((fstat(fd, &status) != 0) || (static_cast<size_t>(status.st_size) < sizeof(BinaryHeader))) {
+    close(fd);
+    throw std::runtime_error("The binary file " + fileName + " is too small.");
+  }
+  m_size = status.st_size;
+  m_address = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (m_address == MAP_FAILED) {
+    throw std::runtime_error("Couldn't memory map the binary file " + fileName + ".");
+  }
+  // Records are read in order.
+  madvise(m_address, m_size, MADV_SEQUENTIAL);
+
+  const BinaryHeader* header = static_cast<const BinaryHeader*>(m_address);
+  std::string error;
+  if (memcmp(header->magic, BinaryMagic, sizeof(BinaryMagic)) != 0) {
+    error = "isn't in the binary format.";
+  }
+  else if (header->type != type) {
+    error = "has values of a different datatype.";
+  }
+  else if (header->arity != arity) {
+    error = "has a different number of values in every record.";
+  }
+  else {
+    m_count = header->count;
+    size_t valueSize = ((type == binaryType<uint64_t>()) || (type == binaryType<int64_t>()) || (type == binaryType<double>())) ? 8 : 4;
+    if ((m_size - sizeof(BinaryHeader)) / (valueSize * arity) < m_count) {
+      error = "is truncated.";
+    }
+  }
+  if (!error.empty()) {
+    munmap(m_address, m_size);
+    throw std::runtime_error("The binary file " + fileName + " " + error);
+  }
+}
+
+/**
+ * @brief  Function for checking if the given file is in the binary format.
+ *
+ * @param fileName  Name of the file.
+ *
+ * @return  true if the file starts with the magic string of the binary format.
+ */
+bool
+BinaryFile::isBinary(
+  const std::string& fileName
+)
+{
+  std::ifstream file(fileName, std::ios::binary);
+  char magic[sizeof(BinaryMagic)];
+  if (!file.read(magic, sizeof(magic))) {
+    return false;
+  }
+  return (memcmp(magic, BinaryMagic, sizeof(BinaryMagic)) == 0);
+}
+
+/**
+ * @brief  Function for writing records to a file in the binary format.
+ *
+ * @param fileName   Name of the file to be written.
+ * @param type       Type of the values.
+ * @param arity      Number of values in every record.
+ * @param data       Pointer to the first value of the first record.
+ * @param valueSize  Size of every value in bytes.
+ * @param count      Number of records.
+ */
+void
+BinaryFile::write(
+  const std::string& fileName,
+  const uint32_t type,
+  const uint32_t arity,
+  const void* data,
+  const size_t valueSize,
+  const size_t count
+)
+{
+  std::ofstream file(fileName, std::ios::binary);
+  writeHeader(file, type, arity, count);
+  file.write(static_cast<const char*>(data), count * arity * valueSize);
+  if (!file) {
+    throw std::runtime_error("Couldn't write the binary file " + fileName + ".");
+  }
+}
+
+/**
+ * @brief  Function for writing the header of a binary file, for files whose records are written separately.
+ *
+ * @param file   Stream to which the header is written.
+ * @param type   Type of the values.
+ * @param arity  Number of values in every record.
+ * @param count  Number of records.
+ */
+void
+BinaryFile::writeHeader(
+  std::ostream& file,
+  const uint32_t type,
+  const uint32_t arity,
+  const size_t count
+)
+{
+  checkLittleEndian();
+  BinaryHeader header;
+  memcpy(header.magic, BinaryMagic, sizeof(BinaryMagic));
+  header.type = type;
+  header.arity = arity;
+  header.count = count;
+  header.reserved = 0;
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+}
+
+/**
+ * @brief  Function for accessing the records in the file.
+ *
+ * @return  Pointer to the first value of the first record.
+ */
+const void*
+BinaryFile::data(
+) const
+{
+  return static_cast<const char*>(m_address) + sizeof(BinaryHeader);
+}
+
+/**
+ * @brief  Function for getting the number of records in the file.
+ *
+ * @return  The number of records.
+ */
+size_t
+BinaryFile::count(
+) const
+{
+  return m_count;
+}
+
+/**
+ * @brief  Destructor, which unmaps the file.
+ */
+BinaryFile::~BinaryFile(
+)
+{
+  munmap(m_address, m_size);
+}
+
+// Types of the values in the binary files.
+template <> uint32_t binaryType<uint32_t>() { return 1; }
+template <> uint32_t binaryType<int32_t>() { return 2; }
+template <> uint32_t binaryType<uint64_t>() { return 3; }
+template <> uint32_t binaryType<int64_t>() { return 4; }
+template <> uint32_t binaryType<float>() { return 5; }
+template <> uint32_t binaryType<double>() { return 6; }
@@ -0,0 +1,86 @@
+/**
+ * @file BinaryFile.hpp
+ * @brief Declaration of BinaryFile functions.
+ * @author Ankit Srivastava <asrivast@gatech.edu>
+ *
+ * Copyright 2018 Georgia Institute of Technology
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef BINARYFILE_HPP_
+#define BINARYFILE_HPP_
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+
+/**
+ * @brief  Class for memory mapping files in the binary format for intervals and points.
+ *
+ * All the fields are stored in little-endian byte order. A file starts with a 32 byte header:
+ *   bytes  0-7   magic string "STABBIN1"
+ *   bytes  8-11  type of the values: 1 (uint32), 2 (int32), 3 (uint64), 4 (int64), 5 (float), or 6 (double)
+ *   bytes 12-15  number of values in every record, 2 for intervals and 1 for points
+ *   bytes 16-23  number of records
+ *   bytes 24-31  reserved, set to 0
+ * The header is followed by all the records, with the limits of an interval stored as lower followed by upper.
+ */
+class BinaryFile {
+public:
+  BinaryFile(const std::string&, const uint32_t, const uint32_t);
+
+  static
+  bool
+  isBinary(const std::string&);
+
+  static
+  void
+  write(const std::string&, const uint32_t, const uint32_t, const void*, const size_t, const size_t);
+
+  static
+  void
+  writeHeader(std::ostream&, const uint32_t, const uint32_t, const size_t);
+
+  const void*
+  data() const;
+
+  size_t
+  count() const;
+
+  ~BinaryFile();
+
+private:
+  BinaryFile(const BinaryFile&);
+
+  BinaryFile&
+  operator=(const BinaryFile&);
+
+private:
+  void* m_address;
+  size_t m_size;
+  size_t m_count;
+}; // class BinaryFile
+
+template <typename ValueType>
+uint32_t
+binaryType();
+
+template <> uint32_t binaryType<uint32_t>();
+template <> uint32_t binaryType<int32_t>();
+template <> uint32_t binaryType<uint64_t>();
+template <> uint32_t binaryType<int64_t>();
+template <> uint32_t binaryType<float>();
+template <> uint32_t binaryType<double>();
+
+#endif // BINARYFILE_HPP_
@@ -0,0 +1,120 @@
+/**
+ * @file BoundedQueue.hpp
+ * @brief Declaration and implementation of a bounded blocking queue.
+ * @author Ankit Srivastava <asrivast@gatech.edu>
+ *
+ * Copyright 2018 Georgia Institute of Technology
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef BOUNDEDQUEUE_HPP_
+#define BOUNDEDQUEUE_HPP_
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <utility>
+
+
+/**
+ * @brief  Class for passing items between the stages of a pipeline, with a limit on the number of items in flight.
+ *
+ * @tparam ItemType  Type of the items in the queue.
+ *
+ * Pushing blocks while the queue is full and popping blocks while it is empty.
+ * Once the queue is closed, pushing fails and popping fails after the remaining items have been popped.
+ */
+template <typename ItemType>
+class BoundedQueue {
+public:
+  BoundedQueue(
+    const size_t capacity
+  ) : m_items(),
+      m_mutex(),
+      m_notFull(),
+      m_notEmpty(),
+      m_capacity(capacity),
+      m_closed(false)
+  {
+  }
+
+  /**
+   * @brief  Function for appending an item to the queue.
+   *
+   * @return  false if the queue was closed and the item was discarded.
+   */
+  bool
+  push(
+    ItemType&& item
+  )
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_notFull.wait(lock, [this]() { return m_closed || (m_items.size() < m_capacity); });
+    if (m_closed) {
+      return false;
+    }
+    m_items.push_back(std::move(item));
+    m_notEmpty.notify_one();
+    return true;
+  }
+
+  /**
+   * @brief  Function for removing the first item from the queue.
+   *
+   * @return  false if the queue was closed and there are no more items.
+   */
+  bool
+  pop(
+    ItemType& item
+  )
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_notEmpty.wait(lock, [this]() { return m_closed || !m_items.empty(); });
+    if (m_items.empty()) {
+      return false;
+    }
+    item = std::move(m_items.front());
+    m_items.pop_front();
+    m_notFull.notify_one();
+    return true;
+  }
+
+  /**
+   * @brief  Function for closing the queue, which wakes up all the waiting threads.
+   */
+  void
+  close(
+  )
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_closed = true;
+    m_notFull.notify_all();
+    m_notEmpty.notify_all();
+  }
+
+private:
+  BoundedQueue(const BoundedQueue&);
+
+  BoundedQueue&
+  operator=(const BoundedQueue&);
+
+private:
+  std::deque<ItemType> m_items;
+  std::mutex m_mutex;
+  std::condition_variable m_notFull;
+  std::condition_variable m_notEmpty;
+  size_t m_capacity;
+  bool m_closed;
+}; // class BoundedQueue
+
+#endif // BOUNDEDQUEUE_HPP_
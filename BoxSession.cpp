@@ -0,0 +1,307 @@
+/**
+ * @file BoxSession.cpp
+ * @brief Implementation of BoxSession functions.
+ * @author Ankit Srivastava <asrivast@gatech.edu>
+ *
+ * Copyright 2018 Georgia Institute of Technology
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "BoxSession.hpp"
+#include "Parallel.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+
+
+/**
+ * @brief  Constructor for preparing the given engine for stabbing the given boxes.
+ *
+ * @tparam LimitType       Datatype of the box limits.
+ * @tparam D               Number of dimensions.
+ * @param  boxes           Boxes to be stabbed.
+ * @param  engine          Name of the engine to be used for checking boxes.
+ * @param  deviceNames     Names of the AP devices to be used for checking boxes.
+ * @param  sharding        How the work is split between the devices (auto, intervals, points).
+ * @param  macrosDir       Directory which contains all the comparator macros.
+ * @param  fsmName         Name of the FSM file to be written, to which _d<k> is appended for the k-th dimension.
+ * @param  cacheDir        Directory in which compiled automata are cached. Empty if no caching is needed.
+ * @param  maxComparators  Maximum number of comparators in one automaton. 0 if the capacity of the board should be used.
+ * @param  maxChunkSize    Maximum size of the flow that can be streamed to the AP.
+ * @param  numThreads      Number of threads to be used on the host. 0 means one thread per hardware thread.
+ *
+ * Both the tree and the sweep engines use the packed R-tree, since sweeping doesn't extend to more than one dimension.
+ */
+template <typename LimitType, unsigned D>
+BoxSession<LimitType, D>::BoxSession(
+  const Boxes<LimitType, D>& boxes,
+  const std::string& engine,
+  const std::vector<std::string>& deviceNames,
+  const std::string& sharding,
+  const std::string& macrosDir,
+  const std::string& fsmName,
+  const std::string& cacheDir,
+  const size_t maxComparators,
+  const size_t maxChunkSize,
+  const unsigned numThreads
+) : m_boxes(boxes),
+    m_engine(engine),
+    m_numThreads(getNumThreads(numThreads)),
+    m_tree(),
+    m_owners(),
+    m_intervals(),
+    m_sessions()
+{
+  if (m_engine == "ap") {
+    // The sessions aren't created for no boxes, since there is nothing to program.
+    if (boxes.count() > 0) {
+      for (unsigned k = 0; k < D; ++k) {
+        m_intervals[k] = boxes.intervals(k, m_owners[k]);
+        const std::string dimensionFsm = fsmName.empty() ? fsmName : (fsmName + "_d" + std::to_string(k));
+        m_sessions[k].reset(new StabbingSession<LimitType>(m_intervals[k], engine, deviceNames, sharding, macrosDir, dimensionFsm, cacheDir, maxComparators, 0, maxChunkSize, numThreads));
+      }
+    }
+  }
+  else if ((m_engine == "tree") || (m_engine == "sweep")) {
+    m_tree.reset(new BoxTree<LimitType, D>(boxes.data(), boxes.count()));
+  }
+  else {
+    throw std::runtime_error("Unsupported engine.");
+  }
+}
+
+/**
+ * @brief  Function for checking which boxes are stabbed by the given points.
+ *
+ * @tparam LimitType  Datatype of the box limits.
+ * @tparam D          Number of dimensions.
+ * @param  points     Points to be checked.
+ *
+ * @return  Indices of the boxes which are stabbed by every point.
+ */
+template <typename LimitType, unsigned D>
+StabbedIntervals
+BoxSession<LimitType, D>::query(
+  const std::vector<Point>& points
+)
+{
+  if (m_engine == "ap") {
+    return queryAutomaton(points, nullptr);
+  }
+  return queryTree(points, nullptr);
+}
+
+/**
+ * @brief  Function for counting the boxes which are stabbed by the given points.
+ *
+ * @tparam LimitType  Datatype of the box limits.
+ * @tparam D          Number of dimensions.
+ * @param  points     Points to be checked.
+ *
+ * @return  Number of boxes stabbed by every point.
+ */
+template <typename LimitType, unsigned D>
+std::vector<size_t>
+BoxSession<LimitType, D>::count(
+  const std::vector<Point>& points
+)
+{
+  std::vector<size_t> counts(points.size());
+  if (m_engine == "ap") {
+    queryAutomaton(points, counts.data());
+  }
+  else {
+    queryTree(points, counts.data());
+  }
+  return counts;
+}
+
+/**
+ * @brief  Function for checking which of the given points stab any box.
+ *
+ * @tparam LimitType  Datatype of the box limits.
+ * @tparam D          Number of dimensions.
+ * @param  points     Points to be checked.
+ *
+ * @return  A bit for every point, which is set if the point stabs at least one box.
+ */
+template <typename LimitType, unsigned D>
+std::vector<bool>
+BoxSession<LimitType, D>::any(
+  const std::vector<Point>& points
+)
+{
+  std::vector<size_t> counts(count(points));
+  std::vector<bool> stabbing(counts.size());
+  for (size_t p = 0; p < counts.size(); ++p) {
+    stabbing[p] = (counts[p] > 0);
+  }
+  return stabbing;
+}
+
+/**
+ * @brief  Function for checking which boxes are stabbed by the given points, by streaming their coordinates to the AP.
+ *
+ * @tparam LimitType  Datatype of the box limits.
+ * @tparam D          Number of dimensions.
+ * @param  points     Points to be checked.
+ * @param  counts     Array in which the number of stabbed boxes is stored for every point, instead of the boxes.
+ *
+ * @return  Indices of the boxes which are stabbed by every point, unless only the counts are needed.
+ *
+ * Only the k-th coordinates of the points are streamed to the session of the k-th dimension, so every report
+ * is for an interval of the dimension of the coordinate. A coordinate can't stab both the halves of an interval
+ * which was split at zero, so the boxes stabbed by every coordinate are distinct, and the sorted boxes of all
+ * the coordinates of a point are intersected to get the boxes stabbed by the point.
+ */
+template <typename LimitType, unsigned D>
+StabbedIntervals
+BoxSession<LimitType, D>::queryAutomaton(
+  const std::vector<Point>& points,
+  size_t* const counts
+)
+{
+  if (!m_sessions[0]) {
+    return StabbedIntervals(std::vector<size_t>(points.size() + 1, 0), std::vector<size_t>());
+  }
+  std::vector<StabbedIntervals> chunks;
+  for (size_t first = 0; first < points.size(); first += MaxChunkPoints) {
+    const size_t last = std::min(first + MaxChunkPoints, points.size());
+    std::array<StabbedIntervals, D> stabbed;
+    for (unsigned k = 0; k < D; ++k) {
+      std::vector<LimitType> coordinates;
+      coordinates.reserve(last - first);
+      for (size_t p = first; p < last; ++p) {
+        coordinates.push_back(points[p][k]);
+      }
+      stabbed[k] = m_sessions[k]->query(Points<LimitType>(std::move(coordinates)));
+    }
+
+    std::vector<StabbedIntervals> stabbedBoxes(m_numThreads);
+    parallelFor(m_numThreads, last - first,
+                [&](const unsigned t, const size_t begin, const size_t end)
+                {
+                  std::vector<size_t> offsets(1, 0);
+                  std::vector<size_t> indices;
+                  // Boxes stabbed by all the coordinates of the current point so far, and by the next coordinate.
+                  std::vector<size_t> candidates;
+                  std::vector<size_t> next;
+                  std::vector<size_t> common;
+                  for (size_t p = begin; p < end; ++p) {
+                    candidates.clear();
+                    for (const size_t* i = stabbed[0].begin(p); i != stabbed[0].end(p); ++i) {
+                      candidates.push_back(m_owners[0][*i]);
+                    }
+                    std::sort(candidates.begin(), candidates.end());
+                    for (unsigned k = 1; (k < D) && !candidates.empty(); ++k) {
+                      next.clear();
+                      for (const size_t* i = stabbed[k].begin(p); i != stabbed[k].end(p); ++i) {
+                        next.push_back(m_owners[k][*i]);
+                      }
+                      std::sort(next.begin(), next.end());
+                      common.clear();
+                      std::set_intersection(candidates.begin(), candidates.end(), next.begin(), next.end(), std::back_inserter(common));
+                      candidates.swap(common);
+                    }
+                    if (counts != nullptr) {
+                      counts[first + p] = candidates.size();
+                    }
+                    else {
+                      indices.insert(indices.end(), candidates.begin(), candidates.end());
+                      offsets.push_back(indices.size());
+                    }
+                  }
+                  if (counts == nullptr) {
+                    stabbedBoxes[t] = StabbedIntervals(std::move(offsets), std::move(indices));
+                  }
+                });
+    if (counts == nullptr) {
+      chunks.push_back(StabbedIntervals(std::move(stabbedBoxes)));
+    }
+  }
+  if (counts != nullptr) {
+    return StabbedIntervals();
+  }
+  return StabbedIntervals(std::move(chunks));
+}
+
+/**
+ * @brief  Function for checking which boxes are stabbed by the given points, using the packed R-tree.
+ *
+ * @tparam LimitType  Datatype of the box limits.
+ * @tparam D          Number of dimensions.
+ * @param  points     Points to be checked.
+ * @param  counts     Array in which the number of stabbed boxes is stored for every point, instead of the boxes.
+ *
+ * @return  Indices of the boxes which are stabbed by every point, unless only the counts are needed.
+ */
+template <typename LimitType, unsigned D>
+StabbedIntervals
+BoxSession<LimitType, D>::queryTree(
+  const std::vector<Point>& points,
+  size_t* const counts
+) const
+{
+  std::vector<StabbedIntervals> stabbedBoxes(m_numThreads);
+  parallelFor(m_numThreads, points.size(),
+              [&](const unsigned t, const size_t first, const size_t last)
+              {
+                std::vector<size_t> offsets(1, 0);
+                std::vector<size_t> indices;
+                for (size_t p = first; p < last; ++p) {
+                  m_tree->stab(points[p], indices);
+                  if (counts != nullptr) {
+                    counts[p] = indices.size();
+                    indices.clear();
+                  }
+                  else {
+                    offsets.push_back(indices.size());
+                  }
+                }
+                if (counts == nullptr) {
+                  stabbedBoxes[t] = StabbedIntervals(std::move(offsets), std::move(indices));
+                }
+              });
+  if (counts != nullptr) {
+    return StabbedIntervals();
+  }
+  return StabbedIntervals(std::move(stabbedBoxes));
+}
+
+/**
+ * @brief  Default destructor.
+ *
+ * @tparam LimitType  Datatype of the box limits.
+ * @tparam D          Number of dimensions.
+ */
+template <typename LimitType, unsigned D>
+BoxSession<LimitType, D>::~BoxSession(
+)
+{
+}
+
+// Explicit class instantiation.
+template class BoxSession<uint32_t, 2>;
+template class BoxSession<int32_t, 2>;
+template class BoxSession<uint64_t, 2>;
+template class BoxSession<int64_t, 2>;
+template class BoxSession<float, 2>;
+template class BoxSession<double, 2>;
+template class BoxSession<uint32_t, 3>;
+template class BoxSession<int32_t, 3>;
+template class BoxSession<uint64_t, 3>;
+template class BoxSession<int64_t, 3>;
+template class BoxSession<float, 3>;
+template class BoxSession<double, 3>;
@@ -0,0 +1,91 @@
+/**
+ * @file BoxSession.hpp
+ * @brief Declaration of BoxSession functions.
+ * @author Ankit Srivastava <asrivast@gatech.edu>
+ *
+ * Copyright 2018 Georgia Institute of Technology
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef BOXSESSION_HPP_
+#define BOXSESSION_HPP_
+
+#include "Boxes.hpp"
+#include "BoxTree.hpp"
+#include "Intervals.hpp"
+#include "StabbedIntervals.hpp"
+#include "StabbingSession.hpp"
+
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+/**
+ * @brief  Class for stabbing a fixed set of D-dimensional boxes with many batches of D-dimensional points.
+ *
+ * @tparam LimitType  Datatype of the limits of the boxes.
+ * @tparam D          Number of dimensions.
+ *
+ * The CPU engines use a packed R-tree of the boxes. The AP engine creates one stabbing session for every
+ * dimension, with the intervals of all the boxes in that dimension, and streams only the k-th coordinates
+ * of the points to the session of the k-th dimension. The boxes stabbed by the D coordinates of a point
+ * are then intersected on the host. The boxes must outlive the session.
+ */
+template <typename LimitType, unsigned D>
+class BoxSession {
+public:
+  typedef typename Boxes<LimitType, D>::Point Point;
+
+public:
+  BoxSession(const Boxes<LimitType, D>&, const std::string&, const std::vector<std::string>&, const std::string&, const std::string&, const std::string&, const std::string&, const size_t, const size_t, const unsigned);
+
+  StabbedIntervals
+  query(const std::vector<Point>&);
+
+  std::vector<size_t>
+  count(const std::vector<Point>&);
+
+  std::vector<bool>
+  any(const std::vector<Point>&);
+
+  ~BoxSession();
+
+private:
+  // Maximum number of points whose coordinates are streamed to the AP at once.
+  static const size_t MaxChunkPoints = 1 << 20;
+
+private:
+  BoxSession(const BoxSession&);
+
+  BoxSession&
+  operator=(const BoxSession&);
+
+  StabbedIntervals
+  queryAutomaton(const std::vector<Point>&, size_t* const);
+
+  StabbedIntervals
+  queryTree(const std::vector<Point>&, size_t* const) const;
+
+private:
+  const Boxes<LimitType, D>& m_boxes;
+  std::string m_engine;
+  unsigned m_numThreads;
+  std::unique_ptr<BoxTree<LimitType, D> > m_tree;
+  std::array<std::vector<size_t>, D> m_owners;
+  std::array<Intervals<LimitType>, D> m_intervals;
+  std::array<std::unique_ptr<StabbingSession<LimitType> >, D> m_sessions;
+}; // class BoxSession
+
+#endif // BOXSESSION_HPP_
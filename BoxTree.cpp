@@ -0,0 +1,189 @@
+/**
+ * @file BoxTree.cpp
+ * @brief Implementation of BoxTree functions.
+ * @author Ankit Srivastava <asrivast@gatech.edu>
+ *
+ * Copyright 2018 Georgia Institute of Technology
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "BoxTree.hpp"
+
+#include "LimitOrder.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+
+/**
+ * @brief  Constructor for building the tree for the given boxes.
+ *
+ * @tparam LimitType  Datatype of the box limits.
+ * @tparam D          Number of dimensions.
+ * @param  boxes      Pointer to the boxes.
+ * @param  count      Number of boxes.
+ */
+template <typename LimitType, unsigned D>
+BoxTree<LimitType, D>::BoxTree(
+  const Box* const boxes,
+  const size_t count
+) : m_levels(),
+    m_indices(count)
+{
+  if (count == 0) {
+    return;
+  }
+  for (size_t i = 0; i < count; ++i) {
+    m_indices[i] = i;
+  }
+  sortTile(boxes, m_indices.begin(), m_indices.end(), 0);
+
+  m_levels.push_back(std::vector<Box>());
+  m_levels.back().reserve(count);
+  for (const size_t& i : m_indices) {
+    m_levels.back().push_back(boxes[i]);
+  }
+  // Add the bounding boxes of the groups of nodes until only the root is left.
+  while (m_levels.back().size() > 1) {
+    const std::vector<Box>& below = m_levels.back();
+    std::vector<Box> level;
+    level.reserve((below.size() + Fanout - 1) / Fanout);
+    for (size_t first = 0; first < below.size(); first += Fanout) {
+      Box bounds = below[first];
+      size_t last = std::min(first + Fanout, below.size());
+      for (size_t c = first + 1; c < last; ++c) {
+        // The limits are ordered like the comparators order them, so that -0.0 bounds +0.0 from below.
+        for (unsigned k = 0; k < D; ++k) {
+          if (limitLess(below[c][k].first, bounds[k].first)) {
+            bounds[k].first = below[c][k].first;
+          }
+          if (limitLess(bounds[k].second, below[c][k].second)) {
+            bounds[k].second = below[c][k].second;
+          }
+        }
+      }
+      level.push_back(bounds);
+    }
+    m_levels.push_back(std::move(level));
+  }
+}
+
+/**
+ * @brief  Function for ordering the given boxes by sort-tile-recursive packing.
+ *
+ * @tparam LimitType  Datatype of the box limits.
+ * @tparam D          Number of dimensions.
+ * @param  boxes      Pointer to all the boxes.
+ * @param  first      Iterator to the first index of the boxes to be ordered.
+ * @param  last       Iterator past the last index of the boxes to be ordered.
+ * @param  k          Dimension by which the boxes are sliced.
+ *
+ * The boxes are split into S slices of whole leaves, where S is the (D - k)-th root of the number of leaves,
+ * so that the leaves end up as close to square as the number of boxes allows.
+ */
+template <typename LimitType, unsigned D>
+void
+BoxTree<LimitType, D>::sortTile(
+  const Box* const boxes,
+  const std::vector<size_t>::iterator first,
+  const std::vector<size_t>::iterator last,
+  const unsigned k
+)
+{
+  // Halves of the limits are added, so that the centers of integer boxes don't overflow.
+  std::sort(first, last,
+            [&boxes, k](const size_t a, const size_t b)
+            { return ((boxes[a][k].first / 2) + (boxes[a][k].second / 2)) <
+                     ((boxes[b][k].first / 2) + (boxes[b][k].second / 2)); });
+  if (k == (D - 1)) {
+    return;
+  }
+  const size_t count = last - first;
+  const size_t numLeaves = (count + Fanout - 1) / Fanout;
+  const size_t numSlices = static_cast<size_t>(std::ceil(std::pow(static_cast<double>(numLeaves), 1.0 / (D - k))));
+  const size_t sliceSize = ((numLeaves + numSlices - 1) / numSlices) * Fanout;
+  for (size_t s = 0; s < count; s += sliceSize) {
+    sortTile(boxes, first + s, first + std::min(s + sliceSize, count), k + 1);
+  }
+}
+
+/**
+ * @brief  Function for finding all the boxes stabbed by the given point.
+ *
+ * @tparam LimitType  Datatype of the box limits.
+ * @tparam D          Number of dimensions.
+ * @param  point      Point to be checked.
+ * @param  stabbed    Container to which the indices of the stabbed boxes are appended.
+ */
+template <typename LimitType, unsigned D>
+void
+BoxTree<LimitType, D>::stab(
+  const Point& point,
+  std::vector<size_t>& stabbed
+) const
+{
+  if (m_levels.empty()) {
+    return;
+  }
+  // Nodes which are still to be visited, as the level and the position in the level.
+  std::vector<std::pair<size_t, size_t> > nodes(1, std::make_pair(m_levels.size() - 1, 0));
+  while (!nodes.empty()) {
+    const size_t l = nodes.back().first;
+    const size_t n = nodes.back().second;
+    nodes.pop_back();
+    const Box& box = m_levels[l][n];
+    bool contains = true;
+    for (unsigned k = 0; (k < D) && contains; ++k) {
+      contains = !limitLess(point[k], box[k].first) && !limitLess(box[k].second, point[k]);
+    }
+    if (!contains) {
+      continue;
+    }
+    if (l == 0) {
+      stabbed.push_back(m_indices[n]);
+    }
+    else {
+      size_t last = std::min((n + 1) * Fanout, m_levels[l - 1].size());
+      for (size_t c = n * Fanout; c < last; ++c) {
+        nodes.push_back(std::make_pair(l - 1, c));
+      }
+    }
+  }
+}
+
+/**
+ * @brief  Default destructor.
+ *
+ * @tparam LimitType  Datatype of the box limits.
+ * @tparam D          Number of dimensions.
+ */
+template <typename LimitType, unsigned D>
+BoxTree<LimitType, D>::~BoxTree(
+)
+{
+}
+
+// Explicit class instantiation.
+template class BoxTree<uint32_t, 2>;
+template class BoxTree<int32_t, 2>;
+template class BoxTree<uint64_t, 2>;
+template class BoxTree<int64_t, 2>;
+template class BoxTree<float, 2>;
+template class BoxTree<double, 2>;
+template class BoxTree<uint32_t, 3>;
+template class BoxTree<int32_t, 3>;
+template class BoxTree<uint64_t, 3>;
+template class BoxTree<int64_t, 3>;
+template class BoxTree<float, 3>;
+template class BoxTree<double, 3>;
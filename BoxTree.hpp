@@ -0,0 +1,67 @@
+/**
+ * @file BoxTree.hpp
+ * @brief Declaration of BoxTree functions.
+ * @author Ankit Srivastava <asrivast@gatech.edu>
+ *
+ * Copyright 2018 Georgia Institute of Technology
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef BOXTREE_HPP_
+#define BOXTREE_HPP_
+
+#include <array>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+
+/**
+ * @brief  Class for a static packed R-tree, used for stabbing D-dimensional boxes on the CPU.
+ *
+ * @tparam LimitType  Datatype of the limits of the boxes.
+ * @tparam D          Number of dimensions.
+ *
+ * The boxes are packed into leaves by sort-tile-recursive bulk loading, i.e., they are sorted into slices
+ * by the centers in the first dimension, every slice is sorted into slices by the centers in the next dimension,
+ * and so on. Every level of the tree stores the bounding boxes of the consecutive groups of nodes in the level
+ * below it, so that the tree doesn't need any pointers.
+ */
+template <typename LimitType, unsigned D>
+class BoxTree {
+public:
+  typedef std::array<std::pair<LimitType, LimitType>, D> Box;
+  typedef std::array<LimitType, D> Point;
+
+public:
+  BoxTree(const Box* const, const size_t);
+
+  void
+  stab(const Point&, std::vector<size_t>&) const;
+
+  ~BoxTree();
+
+private:
+  // Number of children of every node.
+  static const size_t Fanout = 16;
+
+private:
+  void
+  sortTile(const Box* const, const std::vector<size_t>::iterator, const std::vector<size_t>::iterator, const unsigned);
+
+private:
+  std::vector<std::vector<Box> > m_levels;
+  std::vector<size_t> m_indices;
+}; // class BoxTree
+
+#endif // BOXTREE_HPP_
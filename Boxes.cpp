@@ -0,0 +1,210 @@
+/**
+ * @file Boxes.cpp
+ * @brief Implementation of Boxes functions.
+ * @author Ankit Srivastava <asrivast@gatech.edu>
+ *
+ * Copyright 2018 Georgia Institute of Technology
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "Boxes.hpp"
+
+#include "LimitOrder.hpp"
+#include "TextParser.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+
+
+/**
+ * @brief  Default constructor for initializing empty boxes.
+ *
+ * @tparam LimitType  Datatype of the box limits.
+ * @tparam D          Number of dimensions.
+ */
+template <typename LimitType, unsigned D>
+Boxes<LimitType, D>::Boxes(
+) : m_boxes()
+{
+}
+
+/**
+ * @brief  Constructor for reading the boxes from the given text file.
+ *
+ * @tparam LimitType     Datatype of the box limits.
+ * @tparam D             Number of dimensions.
+ * @param  boxesFile     Name of the file with one box per line, as the lower and the upper limits in every dimension.
+ * @param  numThreads    Number of threads to be used for parsing the file.
+ */
+template <typename LimitType, unsigned D>
+Boxes<LimitType, D>::Boxes(
+  const std::string& boxesFile,
+  const unsigned numThreads
+) : m_boxes()
+{
+  parseTextFile(boxesFile, numThreads, m_boxes);
+  for (const Box& box : m_boxes) {
+    for (unsigned k = 0; k < D; ++k) {
+      if (limitLess(box[k].second, box[k].first)) {
+        throw std::runtime_error("The lower limit of a box is after its upper limit in the file " + boxesFile + ".");
+      }
+    }
+  }
+}
+
+/**
+ * @brief  Constructor for taking over the given boxes.
+ *
+ * @tparam LimitType  Datatype of the box limits.
+ * @tparam D          Number of dimensions.
+ * @param  boxes      Boxes to be stored.
+ */
+template <typename LimitType, unsigned D>
+Boxes<LimitType, D>::Boxes(
+  std::vector<Box>&& boxes
+) : m_boxes(std::move(boxes))
+{
+}
+
+/**
+ * @brief  Function for getting a box.
+ *
+ * @tparam LimitType  Datatype of the box limits.
+ * @tparam D          Number of dimensions.
+ * @param  index      Index of the box.
+ */
+template <typename LimitType, unsigned D>
+const typename Boxes<LimitType, D>::Box&
+Boxes<LimitType, D>::get(
+  const size_t index
+) const
+{
+  return m_boxes[index];
+}
+
+/**
+ * @brief  Function for getting a pointer to all the boxes.
+ *
+ * @tparam LimitType  Datatype of the box limits.
+ * @tparam D          Number of dimensions.
+ */
+template <typename LimitType, unsigned D>
+const typename Boxes<LimitType, D>::Box*
+Boxes<LimitType, D>::data(
+) const
+{
+  return m_boxes.data();
+}
+
+/**
+ * @brief  Function for getting the number of boxes.
+ *
+ * @tparam LimitType  Datatype of the box limits.
+ * @tparam D          Number of dimensions.
+ */
+template <typename LimitType, unsigned D>
+size_t
+Boxes<LimitType, D>::count(
+) const
+{
+  return m_boxes.size();
+}
+
+/**
+ * @brief  Function for getting the intervals of all the boxes in the given dimension.
+ *
+ * @tparam LimitType  Datatype of the box limits.
+ * @tparam D          Number of dimensions.
+ * @param  k          Dimension of the intervals.
+ * @param  owners     Vector in which the index of the box is stored for every interval.
+ *
+ * @return  The intervals, in the order of the boxes.
+ *
+ * Intervals of real numbers which cross zero are split in two, so that they can be programmed on the AP.
+ * Both the halves are owned by the same box.
+ */
+template <typename LimitType, unsigned D>
+Intervals<LimitType>
+Boxes<LimitType, D>::intervals(
+  const unsigned k,
+  std::vector<size_t>& owners
+) const
+{
+  std::vector<std::pair<LimitType, LimitType> > intervals;
+  intervals.reserve(m_boxes.size());
+  owners.clear();
+  owners.reserve(m_boxes.size());
+  for (size_t b = 0; b < m_boxes.size(); ++b) {
+    const std::pair<LimitType, LimitType>& interval = m_boxes[b][k];
+    if (std::is_floating_point<LimitType>::value && std::signbit(interval.first) && !std::signbit(interval.second)) {
+      intervals.push_back(std::make_pair(interval.first, static_cast<LimitType>(std::copysign(0.0, interval.first))));
+      owners.push_back(b);
+      intervals.push_back(std::make_pair(static_cast<LimitType>(std::copysign(0.0, interval.second)), interval.second));
+    }
+    else {
+      intervals.push_back(interval);
+    }
+    owners.push_back(b);
+  }
+  return Intervals<LimitType>(std::move(intervals));
+}
+
+/**
+ * @brief  Function for reading D-dimensional points from the given text file.
+ *
+ * @tparam LimitType    Datatype of the coordinates of the points.
+ * @tparam D            Number of dimensions.
+ * @param  pointsFile   Name of the file with one point per line, as the coordinates in every dimension.
+ * @param  numThreads   Number of threads to be used for parsing the file.
+ *
+ * @return  The points, in the order of the lines.
+ */
+template <typename LimitType, unsigned D>
+std::vector<typename Boxes<LimitType, D>::Point>
+Boxes<LimitType, D>::readPoints(
+  const std::string& pointsFile,
+  const unsigned numThreads
+)
+{
+  std::vector<Point> points;
+  parseTextFile(pointsFile, numThreads, points);
+  return points;
+}
+
+/**
+ * @brief  Default destructor.
+ *
+ * @tparam LimitType  Datatype of the box limits.
+ * @tparam D          Number of dimensions.
+ */
+template <typename LimitType, unsigned D>
+Boxes<LimitType, D>::~Boxes(
+)
+{
+}
+
+// Explicit class instantiation.
+template class Boxes<uint32_t, 2>;
+template class Boxes<int32_t, 2>;
+template class Boxes<uint64_t, 2>;
+template class Boxes<int64_t, 2>;
+template class Boxes<float, 2>;
+template class Boxes<double, 2>;
+template class Boxes<uint32_t, 3>;
+template class Boxes<int32_t, 3>;
+template class Boxes<uint64_t, 3>;
+template class Boxes<int64_t, 3>;
+template class Boxes<float, 3>;
+template class Boxes<double, 3>;
@@ -0,0 +1,73 @@
+/**
+ * @file Boxes.hpp
+ * @brief Declaration of Boxes functions.
+ * @author Ankit Srivastava <asrivast@gatech.edu>
+ *
+ * Copyright 2018 Georgia Institute of Technology
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef BOXES_HPP_
+#define BOXES_HPP_
+
+#include "Intervals.hpp"
+
+#include <array>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+/**
+ * @brief  Class for storing D-dimensional boxes, each of which is an interval in every dimension.
+ *
+ * @tparam LimitType  Datatype of the limits of the boxes and of the coordinates of the points.
+ * @tparam D          Number of dimensions.
+ */
+template <typename LimitType, unsigned D>
+class Boxes {
+public:
+  typedef std::array<std::pair<LimitType, LimitType>, D> Box;
+  typedef std::array<LimitType, D> Point;
+
+public:
+  Boxes();
+
+  Boxes(const std::string&, const unsigned);
+
+  Boxes(std::vector<Box>&&);
+
+  const Box&
+  get(const size_t) const;
+
+  const Box*
+  data() const;
+
+  size_t
+  count() const;
+
+  Intervals<LimitType>
+  intervals(const unsigned, std::vector<size_t>&) const;
+
+  ~Boxes();
+
+public:
+  static
+  std::vector<Point>
+  readPoints(const std::string&, const unsigned);
+
+private:
+  std::vector<Box> m_boxes;
+}; // class Boxes
+
+#endif // BOXES_HPP_
@@ -0,0 +1,206 @@
+/**
+ * @file ByteOrder.cpp
+ * @brief Implementation of functions for changing the byte order.
+ * @author Ankit Srivastava <asrivast@gatech.edu>
+ *
+ * Copyright 2018 Georgia Institute of Technology
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "ByteOrder.hpp"
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define BYTEORDER_X86
+#endif
+
+
+/**
+ * @brief  Function for reversing the bytes of every value in an array, one value at a time.
+ *
+ * @param dest   Pointer to the destination array.
+ * @param src    Pointer to the source array.
+ * @param count  Number of values in the array.
+ * @param size   Size of every value.
+ */
+static
+void
+reverseScalar(
+  unsigned char* dest,
+  const unsigned char* src,
+  const size_t count,
+  const size_t size
+)
+{
+  if (size == 4) {
+    for (size_t i = 0; i < count; ++i, dest += 4, src += 4) {
+      uint32_t value;
+      memcpy(&value, src, 4);
+      value = __builtin_bswap32(value);
+      memcpy(dest, &value, 4);
+    }
+  }
+  else if (size == 8) {
+    for (size_t i = 0; i < count; ++i, dest += 8, src += 8) {
+      uint64_t value;
+      memcpy(&value, src, 8);
+      value = __builtin_bswap64(value);
+      memcpy(dest, &value, 8);
+    }
+  }
+  else {
+    for (size_t i = 0; i < count; ++i, dest += size, src += size) {
+      for (size_t b = 0; b < size; ++b) {
+        dest[b] = src[size - 1 - b];
+      }
+    }
+  }
+}
+
+#ifdef BYTEORDER_X86
+/**
+ * @brief  Function for getting the shuffle mask which reverses the bytes of 4 or 8 byte values in 16 bytes.
+ */
+__attribute__((target("ssse3")))
+static
+__m128i
+reverseMask(
+  const size_t size
+)
+{
+  if (size == 4) {
+    return _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+  }
+  else {
+    return _mm_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+  }
+}
+
+/**
+ * @brief  Function for reversing the bytes of every 4 or 8 byte value in an array, 16 bytes at a time.
+ */
+__attribute__((target("ssse3")))
+static
+void
+reverseSSSE3(
+  unsigned char* dest,
+  const unsigned char* src,
+  const size_t count,
+  const size_t size
+)
+{
+  const __m128i mask = reverseMask(size);
+  const size_t numBytes = count * size;
+  size_t i = 0;
+  for (; i + 16 <= numBytes; i += 16) {
+    __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i), _mm_shuffle_epi8(values, mask));
+  }
+  reverseScalar(dest + i, src + i, (numBytes - i) / size, size);
+}
+
+/**
+ * @brief  Function for reversing the bytes of every 4 or 8 byte value in an array, 32 bytes at a time.
+ */
+__attribute__((target("avx2")))
+static
+void
+reverseAVX2(
+  unsigned char* dest,
+  const unsigned char* src,
+  const size_t count,
+  const size_t size
+)
+{
+  const __m256i mask = _mm256_broadcastsi128_si256(reverseMask(size));
+  const size_t numBytes = count * size;
+  size_t i = 0;
+  for (; i + 32 <= numBytes; i += 32) {
+    __m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest + i), _mm256_shuffle_epi8(values, mask));
+  }
+  reverseScalar(dest + i, src + i, (numBytes - i) / size, size);
+}
+#endif // BYTEORDER_X86
+
+typedef void (*ReverseFunction)(unsigned char*, const unsigned char*, const size_t, const size_t);
+
+/**
+ * @brief  Function for selecting the fastest implementation supported by the CPU.
+ */
+static
+ReverseFunction
+selectReverse(
+)
+{
+#ifdef BYTEORDER_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    return reverseAVX2;
+  }
+  if (__builtin_cpu_supports("ssse3")) {
+    return reverseSSSE3;
+  }
+#endif
+  return reverseScalar;
+}
+
+/**
+ * @brief  Function for copying a chunk of memory in reverse.
+ *
+ * @param destPtr  Pointer to the destination memory.
+ * @param srcPtr   Pointer to the source memory.
+ * @param size     Size of the chunk to be copied.
+ */
+void
+reverse_memcpy(
+  void* destPtr,
+  const void* srcPtr,
+  size_t size
+)
+{
+  reverseScalar(static_cast<unsigned char*>(destPtr), static_cast<const unsigned char*>(srcPtr), 1, size);
+}
+
+/**
+ * @brief  Function for copying an array of values, with the bytes of every value in reverse.
+ *
+ * @param destPtr  Pointer to the destination array.
+ * @param srcPtr   Pointer to the source array.
+ * @param count    Number of values in the array.
+ * @param size     Size of every value.
+ *
+ * 4 and 8 byte values are reversed using byte shuffles if the CPU supports them.
+ * The arrays must not overlap.
+ */
+void
+reverse_memcpy_n(
+  void* destPtr,
+  const void* srcPtr,
+  size_t count,
+  size_t size
+)
+{
+  static const ReverseFunction reverse = selectReverse();
+  unsigned char* dest = static_cast<unsigned char*>(destPtr);
+  const unsigned char* src = static_cast<const unsigned char*>(srcPtr);
+  if ((size == 4) || (size == 8)) {
+    reverse(dest, src, count, size);
+  }
+  else {
+    reverseScalar(dest, src, count, size);
+  }
+}
@@ -0,0 +1,32 @@
+/**
+ * @file ByteOrder.hpp
+ * @brief Declaration of functions for changing the byte order.
+ * @author Ankit Srivastava <asrivast@gatech.edu>
+ *
+ * Copyright 2018 Georgia Institute of Technology
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef BYTEORDER_HPP_
+#define BYTEORDER_HPP_
+
+#include <cstddef>
+
+
+void
+reverse_memcpy(void*, const void*, size_t);
+
+void
+reverse_memcpy_n(void*, const void*, size_t, size_t);
+
+#endif // BYTEORDER_HPP_
@@ -0,0 +1,136 @@
+/**
+ * @file ElementTable.cpp
+ * @brief Implementation of ElementTable functions.
+ * @author Ankit Srivastava <asrivast@gatech.edu>
+ *
+ * Copyright 2018 Georgia Institute of Technology
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "ElementTable.hpp"
+
+#include <algorithm>
+
+
+const size_t ElementTable::npos;
+
+/**
+ * @brief  Default constructor for a table without any comparators.
+ */
+ElementTable::ElementTable(
+) : m_elementMap(),
+    m_elementRefs(),
+    m_slots(),
+    m_map(),
+    m_firstKey(0),
+    m_dense(true)
+{
+}
+
+/**
+ * @brief  Constructor for a table of the comparators with the given element references.
+ *
+ * @param elementMap   Element map of the automaton.
+ * @param elementRefs  Element references of the macros of the comparators, in the order of the comparators.
+ */
+ElementTable::ElementTable(
+  ap::ElementMap&& elementMap,
+  const std::vector<ap::ElementRef>& elementRefs
+) : m_elementMap(std::make_shared<const ap::ElementMap>(std::move(elementMap))),
+    m_elementRefs(elementRefs),
+    m_slots(),
+    m_map(),
+    m_firstKey(0),
+    m_dense(true)
+{
+  ap::ElementRefHasher hasher;
+  if (!m_elementRefs.empty()) {
+    size_t firstKey = hasher(m_elementRefs.front()), lastKey = firstKey;
+    for (const ap::ElementRef& elementRef : m_elementRefs) {
+      firstKey = std::min(firstKey, hasher(elementRef));
+      lastKey = std::max(lastKey, hasher(elementRef));
+    }
+    // Use a dense array only if it isn't much larger than the number of comparators.
+    m_dense = (lastKey - firstKey) < (8 * m_elementRefs.size()) + 64;
+    if (m_dense) {
+      m_firstKey = firstKey;
+      m_slots.assign(lastKey - firstKey + 1, npos);
+      for (size_t c = 0; (c < m_elementRefs.size()) && m_dense; ++c) {
+        size_t& slot = m_slots[hasher(m_elementRefs[c]) - m_firstKey];
+        // Hashes which aren't distinct can't be used for indexing.
+        m_dense = (slot == npos);
+        slot = c;
+      }
+    }
+  }
+  if (!m_dense) {
+    m_slots.clear();
+    m_firstKey = 0;
+    for (size_t c = 0; c < m_elementRefs.size(); ++c) {
+      m_map.insert(std::make_pair(m_elementRefs[c], c));
+    }
+  }
+}
+
+/**
+ * @brief  Function for getting the element reference of the macro of a comparator.
+ *
+ * @param comparator  Number of the comparator.
+ *
+ * @return  A const reference to the element reference.
+ */
+const ap::ElementRef&
+ElementTable::get(
+  const size_t comparator
+) const
+{
+  return m_elementRefs[comparator];
+}
+
+/**
+ * @brief  Function for getting the element map of the automaton, which is needed for changing its symbols.
+ */
+const ap::ElementMap&
+ElementTable::elementMap(
+) const
+{
+  return *m_elementMap;
+}
+
+/**
+ * @brief  Function for getting the number of comparators in the table.
+ */
+size_t
+ElementTable::size(
+) const
+{
+  return m_elementRefs.size();
+}
+
+/**
+ * @brief  Function for checking if the comparators are identified using a dense array.
+ */
+bool
+ElementTable::isDense(
+) const
+{
+  return m_dense;
+}
+
+/**
+ * @brief  Default destructor.
+ */
+ElementTable::~ElementTable(
+)
+{
+}
@@ -0,0 +1,102 @@
+/**
+ * @file ElementTable.hpp
+ * @brief Declaration of ElementTable functions.
+ * @author Ankit Srivastava <asrivast@gatech.edu>
+ *
+ * Copyright 2018 Georgia Institute of Technology
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef ELEMENTTABLE_HPP_
+#define ELEMENTTABLE_HPP_
+
+#include "apsdk/Automaton.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+
+/**
+ * @brief  Table for identifying the comparator of an automaton from the element reference of its macro.
+ *
+ * The comparators are numbered in the order in which their element references are given to the table,
+ * which is the order of the comparators in the network. If the hashes of the references are distinct and
+ * span a range which isn't much larger than the number of comparators, as is the case for element indices,
+ * the number of every comparator is stored in a dense array indexed by the hash of its reference, offset by
+ * the smallest hash. Otherwise, the numbers are stored in a hash map keyed by the references.
+ * The element map of the automaton is kept with the table, so that the comparators can be relabeled later.
+ */
+class ElementTable {
+public:
+  static const size_t npos = static_cast<size_t>(-1);
+
+public:
+  ElementTable();
+
+  ElementTable(ap::ElementMap&&, const std::vector<ap::ElementRef>&);
+
+  size_t
+  find(const ap::ElementRef&) const;
+
+  const ap::ElementRef&
+  get(const size_t) const;
+
+  const ap::ElementMap&
+  elementMap() const;
+
+  size_t
+  size() const;
+
+  bool
+  isDense() const;
+
+  ~ElementTable();
+
+private:
+  std::shared_ptr<const ap::ElementMap> m_elementMap;
+  std::vector<ap::ElementRef> m_elementRefs;
+  std::vector<size_t> m_slots;
+  std::unordered_map<ap::ElementRef, size_t, ap::ElementRefHasher> m_map;
+  size_t m_firstKey;
+  bool m_dense;
+}; // class ElementTable
+
+/**
+ * @brief  Function for finding the comparator with the given element reference.
+ *
+ * @param elementRef  Element reference of the macro of the comparator.
+ *
+ * @return  Number of the comparator, or npos if the reference isn't of a comparator.
+ *
+ * Defined here, since it is called for every report.
+ */
+inline
+size_t
+ElementTable::find(
+  const ap::ElementRef& elementRef
+) const
+{
+  if (m_dense) {
+    size_t slot = ap::ElementRefHasher()(elementRef) - m_firstKey;
+    size_t comparator = (slot < m_slots.size()) ? m_slots[slot] : npos;
+    return ((comparator != npos) && (m_elementRefs[comparator] == elementRef)) ? comparator : npos;
+  }
+  else {
+    std::unordered_map<ap::ElementRef, size_t, ap::ElementRefHasher>::const_iterator it = m_map.find(elementRef);
+    return (it != m_map.end()) ? it->second : npos;
+  }
+}
+
+#endif // ELEMENTTABLE_HPP_
@@ -0,0 +1,257 @@
+/**
+ * @file IntervalRuns.cpp
+ * @brief Implementation of IntervalRuns functions.
+ * @author Ankit Srivastava <asrivast@gatech.edu>
+ *
+ * Copyright 2018 Georgia Institute of Technology
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "IntervalRuns.hpp"
+
+#include "LimitOrder.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+
+/**
+ * @brief  Default constructor for an empty set of intervals.
+ *
+ * @tparam LimitType  Datatype of the interval limits.
+ */
+template <typename LimitType>
+IntervalRuns<LimitType>::IntervalRuns(
+) : m_buffer(),
+    m_bufferIndices(),
+    m_runs(),
+    m_size(0)
+{
+}
+
+/**
+ * @brief  Function for adding an interval.
+ *
+ * @tparam LimitType  Datatype of the interval limits.
+ * @param  interval   Interval to be added.
+ * @param  index      Index to be reported for the interval.
+ */
+template <typename LimitType>
+void
+IntervalRuns<LimitType>::insert(
+  const std::pair<LimitType, LimitType>& interval,
+  const size_t index
+)
+{
+  m_buffer.push_back(interval);
+  m_bufferIndices.push_back(index);
+  ++m_size;
+  if (m_buffer.size() == BufferSize) {
+    flush();
+  }
+}
+
+/**
+ * @brief  Function for turning the buffer into a run, after merging the smaller runs into it.
+ *
+ * @tparam LimitType  Datatype of the interval limits.
+ */
+template <typename LimitType>
+void
+IntervalRuns<LimitType>::flush(
+)
+{
+  Run run;
+  run.intervals.swap(m_buffer);
+  run.indices.swap(m_bufferIndices);
+  while (!m_runs.empty() && (m_runs.back().intervals.size() <= run.intervals.size())) {
+    Run& smaller = m_runs.back();
+    run.intervals.insert(run.intervals.end(), smaller.intervals.begin(), smaller.intervals.end());
+    run.indices.insert(run.indices.end(), smaller.indices.begin(), smaller.indices.end());
+    m_runs.pop_back();
+  }
+  run.tree.reset(new IntervalTree<LimitType>(run.intervals.data(), run.intervals.size()));
+  run.lower.reserve(run.intervals.size());
+  run.upper.reserve(run.intervals.size());
+  for (size_t i = 0; i < run.intervals.size(); ++i) {
+    run.lower.push_back(std::make_pair(run.intervals[i].first, run.indices[i]));
+    run.upper.push_back(run.intervals[i].second);
+  }
+  auto compareLimits = [](const std::pair<LimitType, size_t>& a, const std::pair<LimitType, size_t>& b) { return limitLess(a.first, b.first); };
+  std::sort(run.lower.begin(), run.lower.end(), compareLimits);
+  std::sort(run.upper.begin(), run.upper.end(), limitLess<LimitType>);
+  m_runs.push_back(std::move(run));
+}
+
+/**
+ * @brief  Function for finding the intervals stabbed by the given point.
+ *
+ * @tparam LimitType  Datatype of the interval limits.
+ * @param  point      Point to be checked.
+ * @param  stabbed    Vector to which the indices of the stabbed intervals are appended.
+ */
+template <typename LimitType>
+void
+IntervalRuns<LimitType>::stab(
+  const LimitType point,
+  std::vector<size_t>& stabbed
+) const
+{
+  for (const Run& run : m_runs) {
+    size_t first = stabbed.size();
+    run.tree->stab(point, stabbed);
+    // The tree finds the positions of the intervals in the run.
+    for (size_t s = first; s < stabbed.size(); ++s) {
+      stabbed[s] = run.indices[stabbed[s]];
+    }
+  }
+  for (size_t b = 0; b < m_buffer.size(); ++b) {
+    if (!limitLess(point, m_buffer[b].first) && !limitLess(m_buffer[b].second, point)) {
+      stabbed.push_back(m_bufferIndices[b]);
+    }
+  }
+}
+
+/**
+ * @brief  Function for counting the intervals stabbed by the given point.
+ *
+ * @tparam LimitType  Datatype of the interval limits.
+ * @param  point      Point to be checked.
+ *
+ * @return  Number of lower limits not after the point minus the number of upper limits before it, for every run.
+ */
+template <typename LimitType>
+size_t
+IntervalRuns<LimitType>::count(
+  const LimitType point
+) const
+{
+  auto pointBefore = [](const LimitType& point, const std::pair<LimitType, size_t>& limit) { return limitLess(point, limit.first); };
+  size_t stabbed = 0;
+  for (const Run& run : m_runs) {
+    stabbed += std::upper_bound(run.lower.begin(), run.lower.end(), point, pointBefore) - run.lower.begin();
+    stabbed -= std::lower_bound(run.upper.begin(), run.upper.end(), point, limitLess<LimitType>) - run.upper.begin();
+  }
+  for (const std::pair<LimitType, LimitType>& interval : m_buffer) {
+    if (!limitLess(point, interval.first) && !limitLess(interval.second, point)) {
+      ++stabbed;
+    }
+  }
+  return stabbed;
+}
+
+/**
+ * @brief  Function for finding the intervals which start in the given range.
+ *
+ * @tparam LimitType  Datatype of the interval limits.
+ * @param  after      Limit after which the intervals start.
+ * @param  upto       Limit at or before which the intervals start.
+ * @param  starting   Vector to which the indices of the intervals are appended.
+ */
+template <typename LimitType>
+void
+IntervalRuns<LimitType>::starting(
+  const LimitType after,
+  const LimitType upto,
+  std::vector<size_t>& starting
+) const
+{
+  auto pointBefore = [](const LimitType& point, const std::pair<LimitType, size_t>& limit) { return limitLess(point, limit.first); };
+  for (const Run& run : m_runs) {
+    typename std::vector<std::pair<LimitType, size_t> >::const_iterator first, last;
+    first = std::upper_bound(run.lower.begin(), run.lower.end(), after, pointBefore);
+    last = std::upper_bound(first, run.lower.end(), upto, pointBefore);
+    for (; first != last; ++first) {
+      starting.push_back(first->second);
+    }
+  }
+  for (size_t b = 0; b < m_buffer.size(); ++b) {
+    if (limitLess(after, m_buffer[b].first) && !limitLess(upto, m_buffer[b].first)) {
+      starting.push_back(m_bufferIndices[b]);
+    }
+  }
+}
+
+/**
+ * @brief  Function for counting the intervals which start in the given range.
+ *
+ * @tparam LimitType  Datatype of the interval limits.
+ * @param  after      Limit after which the intervals start.
+ * @param  upto       Limit at or before which the intervals start.
+ */
+template <typename LimitType>
+size_t
+IntervalRuns<LimitType>::countStarting(
+  const LimitType after,
+  const LimitType upto
+) const
+{
+  auto pointBefore = [](const LimitType& point, const std::pair<LimitType, size_t>& limit) { return limitLess(point, limit.first); };
+  size_t started = 0;
+  for (const Run& run : m_runs) {
+    typename std::vector<std::pair<LimitType, size_t> >::const_iterator first;
+    first = std::upper_bound(run.lower.begin(), run.lower.end(), after, pointBefore);
+    started += std::upper_bound(first, run.lower.end(), upto, pointBefore) - first;
+  }
+  for (const std::pair<LimitType, LimitType>& interval : m_buffer) {
+    if (limitLess(after, interval.first) && !limitLess(upto, interval.first)) {
+      ++started;
+    }
+  }
+  return started;
+}
+
+/**
+ * @brief  Function for getting the number of added intervals.
+ *
+ * @tparam LimitType  Datatype of the interval limits.
+ */
+template <typename LimitType>
+size_t
+IntervalRuns<LimitType>::size(
+) const
+{
+  return m_size;
+}
+
+/**
+ * @brief  Function for checking if no intervals have been added.
+ *
+ * @tparam LimitType  Datatype of the interval limits.
+ */
+template <typename LimitType>
+bool
+IntervalRuns<LimitType>::empty(
+) const
+{
+  return (m_size == 0);
+}
+
+/**
+ * @brief  Default destructor.
+ *
+ * @tparam LimitType  Datatype of the interval limits.
+ */
+template <typename LimitType>
+IntervalRuns<LimitType>::~IntervalRuns(
+)
+{
+}
+
+// Explicit class instantiation.
+template class IntervalRuns<uint32_t>;
+template class IntervalRuns<int32_t>;
+template class IntervalRuns<uint64_t>;
+template class IntervalRuns<int64_t>;
+template class IntervalRuns<float>;
+template class IntervalRuns<double>;
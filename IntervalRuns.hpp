@@ -0,0 +1,96 @@
+/**
+ * @file IntervalRuns.hpp
+ * @brief Declaration of IntervalRuns functions.
+ * @author Ankit Srivastava <asrivast@gatech.edu>
+ *
+ * Copyright 2018 Georgia Institute of Technology
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef INTERVALRUNS_HPP_
+#define INTERVALRUNS_HPP_
+
+#include "IntervalTree.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+
+/**
+ * @brief  Class for stabbing a growing set of intervals on the CPU, using the logarithmic method.
+ *
+ * @tparam LimitType  Datatype of the limits of the intervals.
+ *
+ * New intervals are added to a small buffer, which is scanned for every point. When the buffer is full,
+ * it becomes a static run with its own interval tree and sorted limits, and all the runs which aren't larger
+ * than the new run are merged into it. Since the sizes of the runs are decreasing, there are only
+ * logarithmically many runs, and every interval is merged into a larger run logarithmically many times.
+ */
+template <typename LimitType>
+class IntervalRuns {
+public:
+  IntervalRuns();
+
+  void
+  insert(const std::pair<LimitType, LimitType>&, const size_t);
+
+  void
+  stab(const LimitType, std::vector<size_t>&) const;
+
+  size_t
+  count(const LimitType) const;
+
+  void
+  starting(const LimitType, const LimitType, std::vector<size_t>&) const;
+
+  size_t
+  countStarting(const LimitType, const LimitType) const;
+
+  size_t
+  size() const;
+
+  bool
+  empty() const;
+
+  ~IntervalRuns();
+
+private:
+  // Maximum number of intervals in the buffer.
+  static const size_t BufferSize = 64;
+
+private:
+  /**
+   * @brief  Static run of intervals, along with the indices given to them on insertion.
+   */
+  struct Run {
+    std::vector<std::pair<LimitType, LimitType> > intervals;
+    std::vector<size_t> indices;
+    std::unique_ptr<IntervalTree<LimitType> > tree;
+    std::vector<std::pair<LimitType, size_t> > lower;
+    std::vector<LimitType> upper;
+  };
+
+private:
+  void
+  flush();
+
+private:
+  std::vector<std::pair<LimitType, LimitType> > m_buffer;
+  std::vector<size_t> m_bufferIndices;
+  std::vector<Run> m_runs;
+  size_t m_size;
+}; // class IntervalRuns
+
+#endif // INTERVALRUNS_HPP_
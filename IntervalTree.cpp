@@ -0,0 +1,174 @@
+/**
+ * @file IntervalTree.cpp
+ * @brief Implementation of IntervalTree functions.
+ * @author Ankit Srivastava <asrivast@gatech.edu>
+ *
+ * Copyright 2018 Georgia Institute of Technology
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "IntervalTree.hpp"
+
+#include "LimitOrder.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+
+/**
+ * @brief  Constructor for building the tree over the given intervals.
+ *
+ * @tparam LimitType  Datatype of the interval limits.
+ * @param  intervals  Intervals to be stored in the tree.
+ * @param  count      Number of intervals.
+ */
+template <typename LimitType>
+IntervalTree<LimitType>::IntervalTree(
+  const std::pair<LimitType, LimitType>* const intervals,
+  const size_t count
+) : m_nodes(),
+    m_lower(),
+    m_upper()
+{
+  m_lower.reserve(count);
+  m_upper.reserve(count);
+  std::vector<size_t> indices(count);
+  for (size_t i = 0; i < count; ++i) {
+    indices[i] = i;
+  }
+  build(intervals, indices);
+}
+
+/**
+ * @brief  Function for recursively building the subtree for the given intervals.
+ *
+ * @tparam LimitType  Datatype of the interval limits.
+ * @param  intervals  All the intervals stored in the tree.
+ * @param  indices    Indices of the intervals in the subtree. The contents are destroyed.
+ *
+ * @return  Index of the root node of the subtree.
+ *
+ * The center of every node is the median of all the limits in its subtree.
+ * Since the center is a limit of one of the intervals, every node stores at least one interval
+ * and the depth of the tree is logarithmic in the number of intervals.
+ */
+template <typename LimitType>
+size_t
+IntervalTree<LimitType>::build(
+  const std::pair<LimitType, LimitType>* const intervals,
+  std::vector<size_t>& indices
+)
+{
+  if (indices.empty()) {
+    return None;
+  }
+  std::vector<LimitType> limits;
+  limits.reserve(2 * indices.size());
+  for (const size_t& i : indices) {
+    limits.push_back(intervals[i].first);
+    limits.push_back(intervals[i].second);
+  }
+  std::nth_element(limits.begin(), limits.begin() + indices.size(), limits.end(), limitLess<LimitType>);
+  const LimitType center = limits[indices.size()];
+
+  std::vector<size_t> left, right;
+  const size_t begin = m_lower.size();
+  for (const size_t& i : indices) {
+    if (limitLess(intervals[i].second, center)) {
+      left.push_back(i);
+    }
+    else if (limitLess(center, intervals[i].first)) {
+      right.push_back(i);
+    }
+    else {
+      m_lower.push_back(std::make_pair(intervals[i].first, i));
+      m_upper.push_back(std::make_pair(intervals[i].second, i));
+    }
+  }
+  const size_t end = m_lower.size();
+  // Intervals containing the center are sorted in the increasing order of the lower limits
+  // and in the decreasing order of the upper limits.
+  std::sort(m_lower.begin() + begin, m_lower.end(),
+            [](const std::pair<LimitType, size_t>& a, const std::pair<LimitType, size_t>& b)
+            { return limitLess(a.first, b.first); });
+  std::sort(m_upper.begin() + begin, m_upper.end(),
+            [](const std::pair<LimitType, size_t>& a, const std::pair<LimitType, size_t>& b)
+            { return limitLess(b.first, a.first); });
+
+  const size_t n = m_nodes.size();
+  Node node = {center, None, None, begin, end};
+  m_nodes.push_back(node);
+  std::vector<size_t>().swap(indices);
+  size_t l = build(intervals, left);
+  m_nodes[n].left = l;
+  size_t r = build(intervals, right);
+  m_nodes[n].right = r;
+  return n;
+}
+
+/**
+ * @brief  Function for finding all the intervals stabbed by the given point.
+ *
+ * @tparam LimitType  Datatype of the interval limits.
+ * @param  point      Point to be checked.
+ * @param  stabbed    Container to which the indices of the stabbed intervals are appended.
+ */
+template <typename LimitType>
+void
+IntervalTree<LimitType>::stab(
+  const LimitType point,
+  std::vector<size_t>& stabbed
+) const
+{
+  size_t n = m_nodes.empty() ? None : 0;
+  while (n != None) {
+    const Node& node = m_nodes[n];
+    if (limitLess(point, node.center)) {
+      for (size_t i = node.begin; (i < node.end) && !limitLess(point, m_lower[i].first); ++i) {
+        stabbed.push_back(m_lower[i].second);
+      }
+      n = node.left;
+    }
+    else if (limitLess(node.center, point)) {
+      for (size_t i = node.begin; (i < node.end) && !limitLess(m_upper[i].first, point); ++i) {
+        stabbed.push_back(m_upper[i].second);
+      }
+      n = node.right;
+    }
+    else {
+      for (size_t i = node.begin; i < node.end; ++i) {
+        stabbed.push_back(m_lower[i].second);
+      }
+      n = None;
+    }
+  }
+}
+
+/**
+ * @brief  Default destructor.
+ *
+ * @tparam LimitType  Datatype of the interval limits.
+ */
+template <typename LimitType>
+IntervalTree<LimitType>::~IntervalTree(
+)
+{
+}
+
+// Explicit class instantiation.
+template class IntervalTree<uint32_t>;
+template class IntervalTree<int32_t>;
+template class IntervalTree<uint64_t>;
+template class IntervalTree<int64_t>;
+template class IntervalTree<float>;
+template class IntervalTree<double>;
@@ -0,0 +1,67 @@
+/**
+ * @file IntervalTree.hpp
+ * @brief Declaration of IntervalTree functions.
+ * @author Ankit Srivastava <asrivast@gatech.edu>
+ *
+ * Copyright 2018 Georgia Institute of Technology
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef INTERVALTREE_HPP_
+#define INTERVALTREE_HPP_
+
+#include <cstddef>
+#include <vector>
+
+
+/**
+ * @brief  Class for a static centered interval tree, used for stabbing intervals on the CPU.
+ *
+ * @tparam LimitType  Datatype of the limits of the intervals.
+ */
+template <typename LimitType>
+class IntervalTree {
+public:
+  IntervalTree(const std::pair<LimitType, LimitType>* const, const size_t);
+
+  void
+  stab(const LimitType, std::vector<size_t>&) const;
+
+  ~IntervalTree();
+
+private:
+  /**
+   * @brief  Node of the tree, which stores all the intervals containing its center.
+   */
+  struct Node {
+    LimitType center;
+    size_t left;
+    size_t right;
+    size_t begin;
+    size_t end;
+  };
+
+private:
+  static const size_t None = static_cast<size_t>(-1);
+
+private:
+  size_t
+  build(const std::pair<LimitType, LimitType>* const, std::vector<size_t>&);
+
+private:
+  std::vector<Node> m_nodes;
+  std::vector<std::pair<LimitType, size_t> > m_lower;
+  std::vector<std::pair<LimitType, size_t> > m_upper;
+};
+
+#endif // INTERVALTREE_HPP_
@@ -20,40 +20,27 @@
 #include "Intervals.hpp"
 
 #include "apsdk/Anml.hpp"
-#include "apsdk/Device.hpp"
+#include "BinaryFile.hpp"
+#include "ByteOrder.hpp"
 #include "LabelingAlgorithms.hpp"
-
+#include "LimitOrder.hpp"
+#include "Parallel.hpp"
+#include "Profiler.hpp"
+#include "StabbingSession.hpp"
+#include "TextParser.hpp"
+
+#include <algorithm>
+#include <array>
 #include <cstring>
 #include <cstdint>
 #include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <iterator>
 #include <numeric>
-#include <random>
 #include <sstream>
-#include <unordered_map>
 
-/**
- * @brief  Function for copying a chunk of memory in reverse.
- *
- * @param destPtr  Pointer to the destination memory.
- * @param srcPtr   Pointer to the source memory.
- * @param size     Size of the chunk to be copied.
- */
-static
-void
-reverse_memcpy(
-  void* destPtr,
-  const void* srcPtr,
-  size_t size
-)
-{
-  unsigned char* dest = static_cast<unsigned char*>(destPtr);
-  const unsigned char* src = static_cast<const unsigned char*>(srcPtr);
-  src += (size - 1);
-  for (size_t i = 0; i < size; ++i, ++dest, --src) {
-    memcpy(dest, src, 1);
-  }
-}
+#include <boost/filesystem.hpp>
 
 
 /**
@@ -63,147 +50,285 @@ reverse_memcpy(
  */
 template <typename LimitType>
 Intervals<LimitType>::Intervals(
-) : m_intervals()
+) : m_intervals(),
+    m_file(),
+    m_data(nullptr),
+    m_count(0)
 {
 }
 
 /**
  * @brief  Constructor for reading the intervals from the given file.
+ *         Files in the binary format are memory mapped instead of being read.
  *
  * @tparam LimitType      Datatype of the interval limits.
  * @param  intervalsFile  Name of the file from which intervals are to be read.
+ * @param  numThreads     Number of threads to be used for parsing a text file.
  */
 template <typename LimitType>
 Intervals<LimitType>::Intervals(
-  const std::string& intervalsFile
-) : m_intervals()
+  const std::string& intervalsFile,
+  const unsigned numThreads
+) : m_intervals(),
+    m_file(),
+    m_data(nullptr),
+    m_count(0)
 {
-  std::ifstream intervals(intervalsFile);
-  std::string line;
-  while (std::getline(intervals, line)) {
-    std::istringstream is(line);
-    LimitType x, y;
-    is >> x >> y;
-    m_intervals.push_back(std::make_pair(x, y));
+  ProfiledPhase parse("parse_intervals");
+  if (BinaryFile::isBinary(intervalsFile)) {
+    m_file = std::make_shared<BinaryFile>(intervalsFile, binaryType<LimitType>(), 2);
   }
+  else {
+    parseTextFile(intervalsFile, numThreads, m_intervals);
+  }
+  setData();
+  checkOrder(intervalsFile);
+  parse.addBytes(boost::filesystem::file_size(intervalsFile));
+}
+
+/**
+ * @brief  Function for checking if a real interval crosses zero, in which case it can't be programmed on a comparator.
+ *
+ * @tparam RealType  Datatype of the interval limits.
+ * @param  interval  Interval to be checked.
+ */
+template <typename RealType>
+static
+bool
+crossesZero(
+  const std::pair<RealType, RealType>& interval
+)
+{
+  return std::signbit(interval.first) && !std::signbit(interval.second);
 }
 
 #define INITIALIZE_REAL_FILE(RealType) \
 template <> \
 Intervals<RealType>::Intervals( \
-  const std::string& intervalsFile \
-) : m_intervals() \
+  const std::string& intervalsFile, \
+  const unsigned numThreads \
+) : m_intervals(), \
+    m_file(), \
+    m_data(nullptr), \
+    m_count(0) \
 { \
-  std::ifstream intervals(intervalsFile); \
-  std::string line; \
-  while (std::getline(intervals, line)) { \
-    std::istringstream is(line); \
-    RealType x, y; \
-    is >> x >> y; \
-    if (std::signbit(x) && !std::signbit(y)) { \
-      std::cout << "Splitting the interval [" << x << "," << y << "] into the following two intervals: "; \
-      m_intervals.push_back(std::make_pair(x, std::copysign(0.0, x))); \
-      std::cout << "[" << x << ",-0.0] and "; \
-      m_intervals.push_back(std::make_pair(std::copysign(0.0, y), y)); \
-      std::cout << "[+0.0," << y << "]" << std::endl; \
+  ProfiledPhase parse("parse_intervals"); \
+  std::vector<std::pair<RealType, RealType> > parsed; \
+  if (BinaryFile::isBinary(intervalsFile)) { \
+    m_file = std::make_shared<BinaryFile>(intervalsFile, binaryType<RealType>(), 2); \
+    setData(); \
+    /* The mapped intervals are copied only if some of them have to be split. */ \
+    if (std::any_of(m_data, m_data + m_count, crossesZero<RealType>)) { \
+      parsed.assign(m_data, m_data + m_count); \
+      m_file.reset(); \
     } \
-    else { \
-      m_intervals.push_back(std::make_pair(x, y)); \
+  } \
+  else { \
+    parseTextFile(intervalsFile, numThreads, parsed); \
+  } \
+  if (!m_file) { \
+    m_intervals.reserve(parsed.size()); \
+    for (const std::pair<RealType, RealType>& interval : parsed) { \
+      RealType x = interval.first, y = interval.second; \
+      if (crossesZero(interval)) { \
+        std::cerr << "Splitting the interval [" << x << "," << y << "] into the following two intervals: "; \
+        m_intervals.push_back(std::make_pair(x, std::copysign(0.0, x))); \
+        std::cerr << "[" << x << ",-0.0] and "; \
+        m_intervals.push_back(std::make_pair(std::copysign(0.0, y), y)); \
+        std::cerr << "[+0.0," << y << "]" << std::endl; \
+      } \
+      else { \
+        m_intervals.push_back(std::make_pair(x, y)); \
+      } \
     } \
   } \
+  setData(); \
+  checkOrder(intervalsFile); \
+  parse.addBytes(boost::filesystem::file_size(intervalsFile)); \
 }
 
 INITIALIZE_REAL_FILE(float)
 INITIALIZE_REAL_FILE(double)
 
 /**
- * @brief  Constructor for generating random points.
+ * @brief  Constructor for taking over the given intervals.
  *
- * @tparam LimitType              Datatype of the interval limits.
- * @tparam RandomNumberGenerator  Type of the random number generator. 
- * @param  numRandom              Number of random intervals to be generated.
- * @param  generator              Instance of the random number generator. 
+ * @tparam LimitType  Datatype of the interval limits.
+ * @param  intervals  Intervals to be stored.
  */
 template <typename LimitType>
-template <typename RandomNumberGenerator>
 Intervals<LimitType>::Intervals(
-  const size_t,
-  RandomNumberGenerator&
-) : m_intervals()
+  std::vector<std::pair<LimitType, LimitType> >&& intervals
+) : m_intervals(std::move(intervals)),
+    m_file(),
+    m_data(nullptr),
+    m_count(0)
 {
-  throw std::runtime_error("Random generation of intervals hasn't been implemented for the datatype.");
+  setData();
 }
 
-// Specialization of the random interval generator constructor for integer datatypes.
-#define INITIALIZE_INTEGER_RANDOM(IntegerType) \
-template <> \
-template <typename RandomNumberGenerator> \
-Intervals<IntegerType>::Intervals( \
-  const size_t numRandom, \
-  RandomNumberGenerator& generator \
-) : m_intervals() \
-{ \
-  IntegerType lower = std::numeric_limits<IntegerType>::min(); \
-  IntegerType upper = std::numeric_limits<IntegerType>::max(); \
-  std::uniform_int_distribution<IntegerType> distribution(lower, upper); \
-  std::cout << "Following are the randomly generated intervals:" << std::endl; \
-  for (size_t i = 0; i < numRandom; ++i) { \
-    IntegerType x = distribution(generator); \
-    IntegerType y = distribution(generator); \
-    if (x > y) { \
-      IntegerType temp = x; \
-      x = y; \
-      y = temp; \
-    } \
-    m_intervals.push_back(std::make_pair(x, y)); \
-    std::cout << "[" << x << "," << y << "]" << std::endl; \
-  } \
-  std::cout << std::endl; \
+/**
+ * @brief  Copy constructor.
+ *
+ * @tparam LimitType  Datatype of the interval limits.
+ * @param  other      Intervals to be copied. Memory mapped intervals are shared.
+ */
+template <typename LimitType>
+Intervals<LimitType>::Intervals(
+  const Intervals& other
+) : m_intervals(other.m_intervals),
+    m_file(other.m_file),
+    m_data(nullptr),
+    m_count(0)
+{
+  setData();
 }
 
-INITIALIZE_INTEGER_RANDOM(uint32_t);
-INITIALIZE_INTEGER_RANDOM(int32_t);
-INITIALIZE_INTEGER_RANDOM(uint64_t);
-INITIALIZE_INTEGER_RANDOM(int64_t);
+/**
+ * @brief  Move constructor.
+ *
+ * @tparam LimitType  Datatype of the interval limits.
+ * @param  other      Intervals to be moved, without copying the stored intervals.
+ */
+template <typename LimitType>
+Intervals<LimitType>::Intervals(
+  Intervals&& other
+) : m_intervals(std::move(other.m_intervals)),
+    m_file(std::move(other.m_file)),
+    m_data(nullptr),
+    m_count(0)
+{
+  setData();
+  other.setData();
+}
 
-// Specialization of the random interval generator constructor for real datatypes.
-#define INITIALIZE_REAL_RANDOM(RealType) \
-template <> \
-template <typename RandomNumberGenerator> \
-Intervals<RealType>::Intervals( \
-  const size_t numRandom, \
-  RandomNumberGenerator& generator \
-) : m_intervals() \
-{ \
-  RealType lower = std::numeric_limits<RealType>::min(); \
-  RealType upper = std::numeric_limits<RealType>::max(); \
-  std::uniform_real_distribution<RealType> distribution(lower, upper); \
-  std::cout << "Following are the randomly generated intervals:" << std::endl; \
-  for (size_t i = 0; i < numRandom; ++i) { \
-    RealType x = distribution(generator); \
-    RealType y = distribution(generator); \
-    if (std::isgreater(x, y)) { \
-      RealType temp = x; \
-      x = y; \
-      y = temp; \
-    } \
-    if (std::signbit(x) && !std::signbit(y)) { \
-      m_intervals.push_back(std::make_pair(x, std::copysign(0.0, x))); \
-      std::cout << "[" << x << ",-0.0]" << std::endl; \
-      m_intervals.push_back(std::make_pair(std::copysign(0.0, y), y)); \
-      std::cout << "[+0.0," << y << "]" << std::endl; \
-    } \
-    else { \
-      m_intervals.push_back(std::make_pair(x, y)); \
-      std::cout << "[" << x << "," << y << "]" << std::endl; \
-    } \
-  } \
-  std::cout << std::endl; \
+/**
+ * @brief  Copy assignment operator.
+ *
+ * @tparam LimitType  Datatype of the interval limits.
+ * @param  other      Intervals to be copied. Memory mapped intervals are shared.
+ *
+ * @return  A reference to the intervals.
+ */
+template <typename LimitType>
+Intervals<LimitType>&
+Intervals<LimitType>::operator=(
+  const Intervals& other
+)
+{
+  m_intervals = other.m_intervals;
+  m_file = other.m_file;
+  setData();
+  return *this;
 }
 
-INITIALIZE_REAL_RANDOM(float);
-INITIALIZE_REAL_RANDOM(double);
+/**
+ * @brief  Move assignment operator.
+ *
+ * @tparam LimitType  Datatype of the interval limits.
+ * @param  other      Intervals to be moved, without copying the stored intervals.
+ *
+ * @return  A reference to the intervals.
+ */
+template <typename LimitType>
+Intervals<LimitType>&
+Intervals<LimitType>::operator=(
+  Intervals&& other
+)
+{
+  m_intervals = std::move(other.m_intervals);
+  m_file = std::move(other.m_file);
+  setData();
+  other.setData();
+  return *this;
+}
 
+/**
+ * @brief  Function for pointing to the intervals, either in the memory mapped file or in the container.
+ *
+ * @tparam LimitType  Datatype of the interval limits.
+ */
+template <typename LimitType>
+void
+Intervals<LimitType>::setData(
+)
+{
+  static_assert(sizeof(std::pair<LimitType, LimitType>) == 2 * sizeof(LimitType), "Limits of the intervals should be contiguous.");
+  if (m_file) {
+    m_data = static_cast<const std::pair<LimitType, LimitType>*>(m_file->data());
+    m_count = m_file->count();
+  }
+  else {
+    m_data = m_intervals.data();
+    m_count = m_intervals.size();
+  }
+}
+
+/**
+ * @brief  Function for checking that no interval has its lower limit after its upper limit.
+ *
+ * @tparam LimitType      Datatype of the interval limits.
+ * @param  intervalsFile  Name of the file from which the intervals were read.
+ *
+ * The engines sweep over the limits or compare them, and assume that every interval starts before it ends.
+ */
+template <typename LimitType>
+void
+Intervals<LimitType>::checkOrder(
+  const std::string& intervalsFile
+) const
+{
+  for (size_t i = 0; i < m_count; ++i) {
+    if (limitLess(m_data[i].second, m_data[i].first)) {
+      throw std::runtime_error("The lower limit of the interval " + std::to_string(i) + " is after its upper limit in the file " + intervalsFile + ".");
+    }
+  }
+}
+
+/**
+ * @brief  Function for accessing all the intervals.
+ *
+ * @tparam LimitType  Datatype of the interval limits.
+ *
+ * @return  Pointer to the first of the intervals, which are stored contiguously.
+ */
+template <typename LimitType>
+const std::pair<LimitType, LimitType>*
+Intervals<LimitType>::data(
+) const
+{
+  return m_data;
+}
+
+/**
+ * @brief  Function for getting the number of intervals.
+ *
+ * @tparam LimitType  Datatype of the interval limits.
+ *
+ * @return  The number of intervals.
+ */
+template <typename LimitType>
+size_t
+Intervals<LimitType>::count(
+) const
+{
+  return m_count;
+}
+
+/**
+ * @brief  Function for writing the intervals to a file in the binary format.
+ *
+ * @tparam LimitType  Datatype of the interval limits.
+ * @param  fileName   Name of the file to be written.
+ */
+template <typename LimitType>
+void
+Intervals<LimitType>::save(
+  const std::string& fileName
+) const
+{
+  BinaryFile::write(fileName, binaryType<LimitType>(), 2, m_data, sizeof(LimitType), m_count);
+}
 
 /**
  * @brief  Function for accessing the interval at a given index.
@@ -219,45 +344,348 @@ Intervals<LimitType>::get(
   const size_t index
 ) const
 {
-  return m_intervals[index];
+  return m_data[index];
 }
 
 /**
- * @brief  Function for generating the automaton for all the intervals.
+ * @brief  Function for hashing a chunk of memory using 64-bit FNV-1a.
+ *
+ * @param hash  Hash of the preceding memory.
+ * @param data  Pointer to the memory.
+ * @param size  Size of the memory in bytes.
+ *
+ * @return  Hash of the preceding memory followed by the given memory.
+ */
+static
+uint64_t
+fnv1a(
+  uint64_t hash,
+  const void* data,
+  const size_t size
+)
+{
+  const unsigned char* bytes = static_cast<const unsigned char*>(data);
+  for (size_t i = 0; i < size; ++i) {
+    hash = (hash ^ bytes[i]) * 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+/**
+ * @brief  Function for reading query intervals from the given file, which may be a text file or a binary file.
+ *
+ * @tparam LimitType    Datatype of the interval limits.
+ * @param  queriesFile  Name of the file from which the query intervals are to be read.
+ * @param  numThreads   Number of threads to be used for parsing a text file.
+ *
+ * @return  The query intervals, in the order of the file.
+ *
+ * Unlike the intervals which are programmed, real queries which cross zero aren't split, since only their
+ * lower limits are streamed and the rest of every query is found using binary searches.
+ * Hence, every query in the file is a single query in the results.
+ */
+template <typename LimitType>
+Intervals<LimitType>
+Intervals<LimitType>::readQueries(
+  const std::string& queriesFile,
+  const unsigned numThreads
+)
+{
+  ProfiledPhase parse("parse_queries");
+  Intervals queries;
+  if (BinaryFile::isBinary(queriesFile)) {
+    queries.m_file = std::make_shared<BinaryFile>(queriesFile, binaryType<LimitType>(), 2);
+  }
+  else {
+    parseTextFile(queriesFile, numThreads, queries.m_intervals);
+  }
+  queries.setData();
+  queries.checkOrder(queriesFile);
+  parse.addBytes(boost::filesystem::file_size(queriesFile));
+  return queries;
+}
+
+/**
+ * @brief  Function for getting the number of comparators which are programmed in one automaton.
+ *
+ * @tparam LimitType      Datatype of the interval limits.
+ * @param maxComparators  Maximum number of comparators in one automaton. 0 if the capacity of the board should be used.
+ *
+ * @return  The number of comparators in one automaton.
+ *
+ * The capacity of the board is estimated assuming that a comparator uses one STE for every macro parameter,
+ * and that the STEs of a comparator are never split across blocks.
+ */
+template <typename LimitType>
+size_t
+Intervals<LimitType>::capacity(
+  const size_t maxComparators
+)
+{
+  if (maxComparators > 0) {
+    return maxComparators;
+  }
+  // An AP board has 32 chips, each with 192 blocks of 256 STEs.
+  const size_t boardBlocks = 32 * 192;
+  const size_t blockSTEs = 256;
+  const size_t comparatorSTEs = (4 * B) - 3;
+  return boardBlocks * (blockSTEs / comparatorSTEs);
+}
+
+/**
+ * @brief  Function for collapsing identical intervals into one.
  *
  * @tparam LimitType  Datatype of the interval limits.
+ * @param  offsets    Offsets of the first original index of every distinct interval in indices,
+ *                    followed by the number of intervals.
+ * @param  indices    Indices of the original intervals, grouped by the distinct interval.
+ *
+ * @return  The distinct intervals, in the order of their first occurrence.
+ *
+ * Intervals are identical if all the bytes of their limits are the same,
+ * so that identical intervals are always programmed identically.
+ */
+template <typename LimitType>
+Intervals<LimitType>
+Intervals<LimitType>::deduplicate(
+  std::vector<size_t>& offsets,
+  std::vector<size_t>& indices
+) const
+{
+  const size_t size = sizeof(std::pair<LimitType, LimitType>);
+  // Sort the indices so that identical intervals are adjacent, in the order of their indices.
+  std::vector<size_t> order(m_count);
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(),
+            [this, size](const size_t a, const size_t b)
+            {
+              int compare = memcmp(&m_data[a], &m_data[b], size);
+              return (compare < 0) || ((compare == 0) && (a < b));
+            });
+  // Find the first occurrence of every interval.
+  std::vector<size_t> first(m_count);
+  for (size_t k = 0; k < m_count; ++k) {
+    bool repeated = (k > 0) && (memcmp(&m_data[order[k - 1]], &m_data[order[k]], size) == 0);
+    first[order[k]] = repeated ? first[order[k - 1]] : order[k];
+  }
+  // Number the distinct intervals in the order of their first occurrence.
+  std::vector<size_t>& number = order;
+  std::vector<std::pair<LimitType, LimitType> > distinct;
+  for (size_t i = 0; i < m_count; ++i) {
+    if (first[i] == i) {
+      number[i] = distinct.size();
+      distinct.push_back(m_data[i]);
+    }
+    else {
+      number[i] = number[first[i]];
+    }
+  }
+  // Group the original indices by the distinct interval.
+  offsets.assign(distinct.size() + 1, 0);
+  for (size_t i = 0; i < m_count; ++i) {
+    ++offsets[number[i] + 1];
+  }
+  std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+  indices.resize(m_count);
+  std::vector<size_t>& next = first;
+  next.assign(offsets.begin(), offsets.end() - 1);
+  for (size_t i = 0; i < m_count; ++i) {
+    indices[next[number[i]]++] = i;
+  }
+  return Intervals(std::move(distinct));
+}
+
+/**
+ * @brief  Function for computing the key of the compiled automata for the intervals in the cache.
+ *
+ * @tparam LimitType       Datatype of the interval limits.
+ * @param  macroFile       Name of the file which contains the comparator macro.
+ * @param  networkName     Name of the ANML network.
+ * @param  numComparators  Number of comparators in one automaton.
+ * @param  numSpares       Number of spare comparators.
+ *
+ * @return  Hash of everything that the compiled automata depend on.
+ */
+template <typename LimitType>
+uint64_t
+Intervals<LimitType>::cacheKey(
+  const std::string& macroFile,
+  const std::string& networkName,
+  const size_t numComparators,
+  const size_t numSpares
+) const
+{
+  std::ifstream macro(macroFile, std::ios::binary);
+  std::string contents((std::istreambuf_iterator<char>(macro)), std::istreambuf_iterator<char>());
+  if (!macro) {
+    throw std::runtime_error("Couldn't read the comparator macro " + macroFile + ".");
+  }
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  // The type of the limits determines the labels, in addition to the number of bytes.
+  uint32_t type = binaryType<LimitType>();
+  size_t bytes = B;
+  hash = fnv1a(hash, &type, sizeof(type));
+  hash = fnv1a(hash, &bytes, sizeof(bytes));
+  hash = fnv1a(hash, contents.data(), contents.size());
+  hash = fnv1a(hash, networkName.data(), networkName.size());
+  hash = fnv1a(hash, &numComparators, sizeof(numComparators));
+  hash = fnv1a(hash, &numSpares, sizeof(numSpares));
+  hash = fnv1a(hash, &m_count, sizeof(m_count));
+  hash = fnv1a(hash, m_data, m_count * sizeof(std::pair<LimitType, LimitType>));
+  return hash;
+}
+
+/**
+ * @brief  Function for getting the element references of the comparator macros in a network.
+ *
+ * @param elementMap      Element map of the compiled network.
+ * @param networkName     Name of the ANML network.
+ * @param numComparators  Number of comparators in the network.
+ *
+ * @return  The element references, in the order of the comparators.
+ */
+static
+std::vector<ap::ElementRef>
+getElementRefs(
+  const ap::ElementMap& elementMap,
+  const std::string& networkName,
+  const size_t numComparators
+)
+{
+  std::vector<ap::ElementRef> elementRefs;
+  elementRefs.reserve(numComparators);
+  // Only the index at the end of the name changes from one macro to the next.
+  std::string macroName(networkName + ".comparator_");
+  const size_t prefixSize = macroName.size();
+  for (size_t i = 0; i < numComparators; ++i) {
+    macroName.resize(prefixSize);
+    macroName += std::to_string(i);
+    elementRefs.push_back(elementMap.getElementRef(macroName));
+  }
+  return elementRefs;
+}
+
+/**
+ * @brief  Function for getting the references of the parameters of the comparator macro.
+ *
+ * @tparam B          Number of bytes in the limits of the intervals.
+ * @param comparator  Comparator macro.
+ * @param paramRefs   References of the parameters, indexed by the number of the parameter.
+ *
+ * @return  Number of parameters which are labeled for every comparator.
+ */
+template <unsigned B>
+static
+size_t
+getParamRefs(
+  ap::AnmlMacro& comparator,
+  typename SymbolChangeLabels<B>::ParamRefs& paramRefs
+)
+{
+  size_t numParams = 0;
+  for (size_t p = 1; p <= (4*B)-1; ++p) {
+    if ((p == 3) || (p == (4*B)-3)) {
+      continue;
+    }
+    paramRefs[p] = comparator.getParamFromName("%p" + std::to_string(p));
+    ++numParams;
+  }
+  return numParams;
+}
+
+/**
+ * @brief  Function for generating the automata for all the intervals.
+ *
+ * @tparam LimitType       Datatype of the interval limits.
+ * @param  macrosDir       Directory which contains all the comparator macros.
+ * @param  fsmName         Name of the FSM file to be written.
+ * @param  cacheDir        Directory in which compiled automata are cached. Empty if no caching is needed.
+ * @param  maxComparators  Maximum number of comparators in one automaton. 0 if the capacity of the board should be used.
+ * @param  numSpares       Number of spare comparators, which are programmed after the intervals.
+ * @param  numThreads      Number of threads to be used for labeling the comparators. 0 means one thread per hardware thread.
+ *
+ * @return  The automata, each for a consecutive range of the intervals, along with the table
+ *          for identifying the comparator from macro reference, which is the same for all the automata.
+ *
+ * If all the intervals don't fit in one automaton, the network is compiled only once
+ * and every automaton is obtained by substituting the symbols for its range of intervals.
+ * The c-th comparator of the n-th automaton is programmed with the (n * capacity(maxComparators) + c)-th interval.
+ * The comparators which are left over in the last automaton don't correspond to any interval.
+ * If spare comparators are requested, they are compiled after the intervals and disabled, along with the
+ * left over comparators, so that intervals can later be programmed on them using relabel().
  *
- * @return  The automaton for all the intervals and a map for identifying the interval from macro reference.  
+ * The cache stores the AP-FSMs and the element map of the compiled automata in files named after the hash
+ * of the intervals, the comparator macro, the network name, and the numbers of comparators and spares.
+ * Element references can't be stored directly, so the table of the comparators is restored
+ * from the element map using the macro names.
  */
 template <typename LimitType>
-std::pair<ap::Automaton, typename Intervals<LimitType>::ElementRefIntervalMap>
+std::pair<std::vector<ap::Automaton>, ElementTable>
 Intervals<LimitType>::program(
   const std::string& macrosDir,
-  const std::string& fsmName
+  const std::string& fsmName,
+  const std::string& cacheDir,
+  const size_t maxComparators,
+  const size_t numSpares,
+  const unsigned numThreads
 ) const
 {
   std::string networkName(fsmName);
   if (networkName.empty()) {
     networkName = std::to_string(B) + "bytes_network";
   }
+  std::string c = macrosDir + "/" + std::to_string(B) + "bytes_compiled.anml";
+
+  size_t perAutomaton = capacity(maxComparators);
+  size_t numSlots = m_count + numSpares;
+  size_t numComparators = std::min(perAutomaton, numSlots);
+  size_t numAutomata = std::max((numSlots + perAutomaton - 1) / perAutomaton, static_cast<size_t>(1));
+  std::vector<ap::Automaton> automata;
+  Profiler::addCount("automata", numAutomata);
+  Profiler::addCount("comparators", numAutomata * numComparators);
+  // Names of the files to which the automata are written.
+  auto automatonFile = [numAutomata](const std::string& prefix, const size_t n)
+                       { return (numAutomata > 1) ? (prefix + "_" + std::to_string(n) + ".fsm") : (prefix + ".fsm"); };
+
+  std::string cachePrefix;
+  if (!cacheDir.empty()) {
+    std::ostringstream key;
+    key << std::hex << std::setw(16) << std::setfill('0') << cacheKey(c, networkName, numComparators, numSpares);
+    cachePrefix = cacheDir + "/" + key.str();
+    std::ifstream cached(cachePrefix + ".intervals");
+    std::string cachedName;
+    size_t cachedCount = 0, cachedAutomata = 0;
+    if ((cached >> cachedName >> cachedCount >> cachedAutomata) &&
+        (cachedName == networkName) && (cachedCount == m_count) && (cachedAutomata == numAutomata)) {
+      // Restore the automata and the element map from the cache.
+      ProfiledPhase restore("restore");
+      ap::ElementMap elementMap(cachePrefix + ".emap");
+      for (size_t n = 0; n < numAutomata; ++n) {
+        automata.push_back(ap::Automaton(automatonFile(cachePrefix, n)));
+        if (!fsmName.empty()) {
+          automata.back().save(automatonFile(fsmName, n));
+        }
+      }
+      if (!fsmName.empty()) {
+        elementMap.save(fsmName + ".emap");
+      }
+      std::vector<ap::ElementRef> elementRefs(getElementRefs(elementMap, networkName, numComparators));
+      return std::make_pair(std::move(automata), ElementTable(std::move(elementMap), elementRefs));
+    }
+  }
+
   // Create ANML workspace and network.
   ap::Anml anml;
   ap::AnmlNetwork network(anml.createNetwork(networkName));
 
   // Load comparator macro.
-  std::string c = macrosDir + "/" + std::to_string(B) + "bytes_compiled.anml";
   ap::AnmlMacro comparator(anml.loadMacro(c));
 
   // Get and store reference for all the macro parameters.
-  std::unordered_map<unsigned, ap::AnmlMacro::ParamRef> paramRefMap;
-  for (size_t p = 1; p <= (4*B)-1; ++p) {
-    if ((p == 3) || (p == (4*B)-3)) {
-      continue;
-    }
-    paramRefMap[p] = comparator.getParamFromName("%p" + std::to_string(p));
-  }
+  typename SymbolChangeLabels<B>::ParamRefs paramRefs;
+  size_t numParams = getParamRefs<B>(comparator, paramRefs);
 
-  for (size_t i = 0; i < m_intervals.size(); ++i) {
+  for (size_t i = 0; i < numComparators; ++i) {
     network.addMacroRef(comparator, "comparator_" + std::to_string(i));
   }
 
@@ -266,102 +694,207 @@ Intervals<LimitType>::program(
     network.exportAnml(fsmName + ".anml");
   }
 
-  // Compile the complete automaton for all the intervals.
+  // Compile the network once for all the automata.
+  ProfiledPhase compile("compile");
   std::pair<ap::Automaton, ap::ElementMap> result = anml.compileAnml();
-  ap::Automaton automaton(std::move(result.first));
+  compile.stop();
+  ap::Automaton compiled(std::move(result.first));
   ap::ElementMap elementMap(std::move(result.second));
+  if (!fsmName.empty()) {
+    compiled.printInfo();
+  }
+  if (numAutomata > 1) {
+    std::cerr << "Programming " << m_count << " intervals in " << numAutomata << " automata." << std::endl;
+  }
 
-  // Container for storing element ref to interval index mapping.
-  ElementRefIntervalMap macroIntervalMap; 
-  // Total number of substitutions needed.
-  size_t changeCount = paramRefMap.size() * m_intervals.size();
-  // Substitute the symbols for all the comparators.
-  ap::SymbolChange changes(changeCount);
-  std::array<unsigned char, B> x, y;
-  for (size_t i = 0; i < m_intervals.size(); ++i) {
-    // Get element reference for the current macro.
-    std::string macroName("comparator_" + std::to_string(i));
-    ap::ElementRef elementRef = elementMap.getElementRef(networkName + "." + macroName);
-    // Reinterpret the limits of the interval as stream of unsigned char bytes.
-    reverse_memcpy(&x[0], &m_intervals[i].first, B);
-    reverse_memcpy(&y[0], &m_intervals[i].second, B);
-    assignLabels<LimitType>(&x[0], &y[0], elementRef, paramRefMap, changes);
-    macroIntervalMap.insert(std::make_pair(elementRef, i));
+  // Get element references for all the macros.
+  std::vector<ap::ElementRef> elementRefs(getElementRefs(elementMap, networkName, numComparators));
+
+  unsigned threads = getNumThreads(numThreads);
+  for (size_t n = 0; n < numAutomata; ++n) {
+    size_t first = n * perAutomaton;
+    // All the comparators are labeled if there are spares, so that the ones without intervals are disabled.
+    size_t last = (numSpares > 0) ? (first + numComparators) : std::min(first + perAutomaton, m_count);
+    ap::Automaton automaton((n + 1 < numAutomata) ? ap::Automaton(compiled) : std::move(compiled));
+    // Label the comparators in parallel, with every thread adding the changes for
+    // its range of the intervals to its own buffer. Small ranges aren't split.
+    unsigned labelThreads = static_cast<unsigned>(std::min(static_cast<size_t>(threads), std::max((last - first) / MinLabelingRange, static_cast<size_t>(1))));
+    std::vector<std::unique_ptr<ap::SymbolChange> > changes(labelThreads);
+    ProfiledPhase label("label", (last - first) * 2 * B);
+    parallelFor(labelThreads, last - first,
+                [&](const unsigned t, const size_t begin, const size_t end)
+                {
+                  if (begin == end) {
+                    return;
+                  }
+                  // Total number of substitutions needed.
+                  changes[t].reset(new ap::SymbolChange(numParams * (end - begin)));
+                  std::array<unsigned char, B> x, y;
+                  for (size_t i = first + begin; i < first + end; ++i) {
+                    SymbolChangeLabels<B> labels(elementRefs[i - first], paramRefs, *changes[t]);
+                    if (i >= m_count) {
+                      disableLabels(labels);
+                      continue;
+                    }
+                    // Reinterpret the limits of the interval as stream of unsigned char bytes.
+                    reverse_memcpy(&x[0], &m_data[i].first, B);
+                    reverse_memcpy(&y[0], &m_data[i].second, B);
+                    assignLabels<LimitType>(&x[0], &y[0], labels);
+                  }
+                });
+    label.stop();
+    // Substitute the symbols for all the comparators.
+    ProfiledPhase substitute("set_symbol");
+    for (const std::unique_ptr<ap::SymbolChange>& change : changes) {
+      if (change) {
+        automaton.setSymbol(elementMap, *change);
+      }
+    }
+    substitute.stop();
+    if (!fsmName.empty()) {
+      automaton.save(automatonFile(fsmName, n));
+    }
+    if (!cachePrefix.empty()) {
+      boost::filesystem::create_directories(boost::filesystem::path(cacheDir));
+      automaton.save(automatonFile(cachePrefix, n));
+    }
+    automata.push_back(std::move(automaton));
   }
-  automaton.setSymbol(elementMap, changes);
   if (!fsmName.empty()) {
-    automaton.printInfo();
-    automaton.save(fsmName + ".fsm");
     elementMap.save(fsmName + ".emap");
   }
+  if (!cachePrefix.empty()) {
+    elementMap.save(cachePrefix + ".emap");
+    // The index file is written last, and atomically, so that incomplete entries are never used.
+    std::string indexFile = cachePrefix + ".intervals";
+    {
+      std::ofstream index(indexFile + ".tmp");
+      index << networkName << " " << m_count << " " << numAutomata << std::endl;
+      if (!index) {
+        throw std::runtime_error("Couldn't write to the cache directory " + cacheDir + ".");
+      }
+    }
+    boost::filesystem::rename(boost::filesystem::path(indexFile + ".tmp"), boost::filesystem::path(indexFile));
+  }
+
+  return std::make_pair(std::move(automata), ElementTable(std::move(elementMap), elementRefs));
+}
+
+/**
+ * @brief  Function for relabeling some of the comparators of an automaton generated by program().
+ *
+ * @tparam LimitType    Datatype of the interval limits.
+ * @param  macrosDir    Directory which contains all the comparator macros.
+ * @param  elements     Table of the comparators of the automaton.
+ * @param  comparators  Numbers of the comparators to be relabeled, each with the interval to be programmed on it,
+ *                      or nullptr if the comparator should be disabled.
+ * @param  automaton    Automaton in which the symbols are substituted.
+ *
+ * Only the macros of the given comparators are changed, so the network doesn't need to be compiled again.
+ */
+template <typename LimitType>
+void
+Intervals<LimitType>::relabel(
+  const std::string& macrosDir,
+  const ElementTable& elements,
+  const std::vector<std::pair<size_t, const std::pair<LimitType, LimitType>*> >& comparators,
+  ap::Automaton& automaton
+)
+{
+  ap::Anml anml;
+  ap::AnmlMacro comparator(anml.loadMacro(macrosDir + "/" + std::to_string(B) + "bytes_compiled.anml"));
+  typename SymbolChangeLabels<B>::ParamRefs paramRefs;
+  size_t numParams = getParamRefs<B>(comparator, paramRefs);
 
-  return std::pair<ap::Automaton, ElementRefIntervalMap>(std::move(automaton), macroIntervalMap);
+  ap::SymbolChange changes(numParams * comparators.size());
+  std::array<unsigned char, B> x, y;
+  for (const std::pair<size_t, const std::pair<LimitType, LimitType>*>& c : comparators) {
+    SymbolChangeLabels<B> labels(elements.get(c.first), paramRefs, changes);
+    if (c.second == nullptr) {
+      disableLabels(labels);
+    }
+    else {
+      reverse_memcpy(&x[0], &c.second->first, B);
+      reverse_memcpy(&y[0], &c.second->second, B);
+      assignLabels<LimitType>(&x[0], &y[0], labels);
+    }
+  }
+  ProfiledPhase substitute("set_symbol");
+  automaton.setSymbol(elements.elementMap(), changes);
 }
 
 /**
- * @brief  Function for checking which intervals are stabbed by the given points. 
+ * @brief  Function for checking which intervals are stabbed by the given points.
  *
- * @tparam LimitType     Datatype of the interval limits.
- * @param  points        Points to be checked.
- * @param  deviceName    Name of the AP device to be used for checking intervals.
- * @param  maxChunkSize  Maximum size of the flow that can be streamed to the AP.
+ * @tparam LimitType       Datatype of the interval limits.
+ * @param  points          Points to be checked.
+ * @param  engine          Name of the engine to be used for checking intervals.
+ * @param  deviceNames     Names of the AP devices to be used for checking intervals.
+ * @param  sharding        How the work is split between the devices (auto, intervals, points).
+ * @param  macrosDir       Directory which contains all the comparator macros.
+ * @param  fsmName         Name of the FSM file to be written.
+ * @param  cacheDir        Directory in which compiled automata are cached. Empty if no caching is needed.
+ * @param  maxComparators  Maximum number of comparators in one automaton. 0 if the capacity of the board should be used.
+ * @param  maxChunkSize    Maximum size of the flow that can be streamed to the AP.
+ * @param  numThreads      Number of threads to be used on the host. 0 means one thread per hardware thread.
  *
- * @return  A map from point index to index of the intervals which are stabbed by the points.
+ * @return  Indices of the intervals which are stabbed by every point.
+ *
+ * A StabbingSession should be used instead for stabbing the intervals with more than one batch of points.
  */
 template <typename LimitType>
-std::unordered_map<size_t, std::vector<size_t> >
+StabbedIntervals
 Intervals<LimitType>::stab(
   const Points<LimitType>& points,
-  const std::string& deviceName,
+  const std::string& engine,
+  const std::vector<std::string>& deviceNames,
+  const std::string& sharding,
   const std::string& macrosDir,
   const std::string& fsmName,
-  const size_t maxChunkSize
+  const std::string& cacheDir,
+  const size_t maxComparators,
+  const size_t maxChunkSize,
+  const unsigned numThreads
 ) const
 {
-  // Get the automaton for the intervals.
-  std::pair<ap::Automaton, ElementRefIntervalMap> automaton(program(macrosDir, fsmName));
-
-  std::unordered_map<size_t, std::vector<size_t> > stabbedIntervals;
-
-  // Create a byte stream from all the points for streaming to the device.
-  std::vector<unsigned char> allPoints(points.count()*B);
-  unsigned char* stream = &allPoints[0];
-  for (size_t p = 0; p < points.count(); ++p) {
-    reverse_memcpy(stream, &points.get(p), B);
-    stream += B;
-  }
+  StabbingSession<LimitType> session(*this, engine, deviceNames, sharding, macrosDir, fsmName, cacheDir, maxComparators, 0, maxChunkSize, numThreads);
+  return session.query(points);
+}
 
-  if (!deviceName.empty()) {
-    // Open the device.
-    ap::Device device(deviceName);
-    // Load the automaton on the device.
-    device.load(ap::Automaton(automaton.first));
-
-    // Ensure that flow chunks end at number boundaries.
-    size_t flowChunkSize = (maxChunkSize / B) * B;
-    // Search for all the points and get the results.
-    std::vector<std::pair<size_t, ap::ElementRef> > allStabs = device.search(allPoints, flowChunkSize);
-
-    const ElementRefIntervalMap& macroIntervalMap = automaton.second;
-    for (const std::pair<size_t, ap::ElementRef>& stab : allStabs) {
-      size_t pointIndex = (stab.first - 1) / B;
-      ap::ElementRef macroRef = stab.second;
-      size_t intervalIndex = macroIntervalMap.at(macroRef);
-      std::unordered_map<size_t, std::vector<size_t> >::iterator it = stabbedIntervals.find(pointIndex);
-      if (it != stabbedIntervals.end()) {
-        (it->second).push_back(intervalIndex);
-      }
-      else {
-        stabbedIntervals.insert(std::make_pair(pointIndex, std::vector<size_t>(1, intervalIndex)));
-      }
-    }
-    // Unload the automaton from the device.
-    device.unload();
-  }
-  else {
-    std::cerr << "WARNING: AP device name was not provided. Unable to determine stabbed intervals." << std::endl;
-  }
-  return stabbedIntervals;
+/**
+ * @brief  Function for checking which intervals overlap the given query intervals.
+ *
+ * @tparam LimitType       Datatype of the interval limits.
+ * @param  queries         Query intervals to be checked.
+ * @param  engine          Name of the engine to be used for checking intervals.
+ * @param  deviceNames     Names of the AP devices to be used for checking intervals.
+ * @param  sharding        How the work is split between the devices (auto, intervals, points).
+ * @param  macrosDir       Directory which contains all the comparator macros.
+ * @param  fsmName         Name of the FSM file to be written.
+ * @param  cacheDir        Directory in which compiled automata are cached. Empty if no caching is needed.
+ * @param  maxComparators  Maximum number of comparators in one automaton. 0 if the capacity of the board should be used.
+ * @param  maxChunkSize    Maximum size of the flow that can be streamed to the AP.
+ * @param  numThreads      Number of threads to be used on the host. 0 means one thread per hardware thread.
+ *
+ * @return  Indices of the intervals which overlap every query interval.
+ */
+template <typename LimitType>
+StabbedIntervals
+Intervals<LimitType>::overlap(
+  const Intervals& queries,
+  const std::string& engine,
+  const std::vector<std::string>& deviceNames,
+  const std::string& sharding,
+  const std::string& macrosDir,
+  const std::string& fsmName,
+  const std::string& cacheDir,
+  const size_t maxComparators,
+  const size_t maxChunkSize,
+  const unsigned numThreads
+) const
+{
+  StabbingSession<LimitType> session(*this, engine, deviceNames, sharding, macrosDir, fsmName, cacheDir, maxComparators, 0, maxChunkSize, numThreads);
+  return session.overlap(queries);
 }
 
 /**
@@ -382,10 +915,3 @@ template class Intervals<uint64_t>;
 template class Intervals<int64_t>;
 template class Intervals<float>;
 template class Intervals<double>;
-
-template Intervals<uint32_t>::Intervals(const size_t, std::default_random_engine&);
-template Intervals<int32_t>::Intervals(const size_t, std::default_random_engine&);
-template Intervals<uint64_t>::Intervals(const size_t, std::default_random_engine&);
-template Intervals<int64_t>::Intervals(const size_t, std::default_random_engine&);
-template Intervals<float>::Intervals(const size_t, std::default_random_engine&);
-template Intervals<double>::Intervals(const size_t, std::default_random_engine&);
@@ -21,10 +21,15 @@
 #define INTERVALS_HPP_
 
 #include "apsdk/Automaton.hpp"
+#include "BinaryFile.hpp"
+#include "ElementTable.hpp"
 #include "Points.hpp"
+#include "StabbedIntervals.hpp"
 
+#include <cstdint>
+#include <memory>
 #include <string>
-#include <unordered_map>
+#include <utility>
 #include <vector>
 
 
@@ -38,31 +43,79 @@ class Intervals {
 public:
   Intervals();
 
-  Intervals(const std::string&);
+  Intervals(const std::string&, const unsigned);
 
-  template <typename RandomNumberGenerator>
-  Intervals(const size_t, RandomNumberGenerator&);
+  Intervals(std::vector<std::pair<LimitType, LimitType> >&&);
+
+  Intervals(const Intervals&);
+
+  Intervals(Intervals&&);
+
+  Intervals&
+  operator=(const Intervals&);
+
+  Intervals&
+  operator=(Intervals&&);
 
   const std::pair<LimitType, LimitType>&
   get(const size_t) const;
 
-  std::unordered_map<size_t, std::vector<size_t> >
-  stab(const Points<LimitType>&, const std::string&, const std::string&, const std::string&, const size_t) const;
+  const std::pair<LimitType, LimitType>*
+  data() const;
+
+  size_t
+  count() const;
+
+  void
+  save(const std::string&) const;
+
+  Intervals
+  deduplicate(std::vector<size_t>&, std::vector<size_t>&) const;
+
+  std::pair<std::vector<ap::Automaton>, ElementTable>
+  program(const std::string&, const std::string&, const std::string&, const size_t, const size_t, const unsigned) const;
+
+  StabbedIntervals
+  stab(const Points<LimitType>&, const std::string&, const std::vector<std::string>&, const std::string&, const std::string&, const std::string&, const std::string&, const size_t, const size_t, const unsigned) const;
+
+  StabbedIntervals
+  overlap(const Intervals&, const std::string&, const std::vector<std::string>&, const std::string&, const std::string&, const std::string&, const std::string&, const size_t, const size_t, const unsigned) const;
 
   ~Intervals();
 
+public:
+  static
+  Intervals
+  readQueries(const std::string&, const unsigned);
+
+  static
+  size_t
+  capacity(const size_t);
+
+  static
+  void
+  relabel(const std::string&, const ElementTable&, const std::vector<std::pair<size_t, const std::pair<LimitType, LimitType>*> >&, ap::Automaton&);
+
 private:
   static const size_t B = sizeof(LimitType);
+  // Minimum number of intervals labeled by one thread.
+  static const size_t MinLabelingRange = 1024;
 
 private:
-  typedef std::unordered_map<ap::ElementRef, size_t, ap::ElementRefHasher> ElementRefIntervalMap;
+  void
+  setData();
 
-private:
-  std::pair<ap::Automaton, ElementRefIntervalMap>
-  program(const std::string&, const std::string&) const;
+  void
+  checkOrder(const std::string&) const;
+
+  uint64_t
+  cacheKey(const std::string&, const std::string&, const size_t, const size_t) const;
 
 private:
   std::vector<std::pair<LimitType, LimitType> > m_intervals;
+  std::shared_ptr<BinaryFile> m_file;
+  const std::pair<LimitType, LimitType>* m_data;
+  size_t m_count;
 };
 
 #endif // INTERVALS_HPP_
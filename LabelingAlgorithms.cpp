@@ -22,33 +22,59 @@
 #include <string>
 
 
+/**
+ * @brief  Function for getting the table of the symbol sets for all the inclusive 1-byte intervals.
+ *
+ * @return  The table, in which the symbol set for [x, y] is stored at (x * 256) + y for x <= y.
+ *
+ * The table is computed on the first call, which is thread-safe.
+ */
+static
+const std::vector<std::string>&
+symbolSetTable(
+)
+{
+  static const std::vector<std::string> table = []()
+                                               {
+                                                 std::vector<std::string> symbolSets(256 * 256);
+                                                 for (unsigned x = 0; x < 256; ++x) {
+                                                   ap::SymbolChange::HexSymbolType hexX = ap::SymbolChange::getHexSymbol(x);
+                                                   symbolSets[(x * 256) + x] = ap::SymbolChange::getSymbolSet(hexX);
+                                                   for (unsigned y = x + 1; y < 256; ++y) {
+                                                     ap::SymbolChange::HexSymbolType hexY = ap::SymbolChange::getHexSymbol(y);
+                                                     symbolSets[(x * 256) + y] = ap::SymbolChange::getSymbolSet(std::make_pair(hexX, hexY));
+                                                   }
+                                                 }
+                                                 return symbolSets;
+                                               }();
+  return table;
+}
+
 /**
  * @brief  Function for getting symbol set corresponding to the given limits of a 1-byte interval.
  *
  * @param lower  Lower limit of the interval. Setting the bool flag to true means that the limit is inclusive.
  * @param upper  Upper limit of the interval. Setting the bool flag to true means that the limit is inclusive.
  *
- * @return  The symbol set for the interval.
+ * @return  The symbol set for the interval, from the precomputed table.
  */
-std::string
+const std::string&
 getIntervalSymbols(
   const std::pair<unsigned char, bool> lower,
   const std::pair<unsigned char, bool> upper
 )
 {
+  static const std::string empty;
   if (((lower.first == 255) && !lower.second) || ((upper.first == 0) && !upper.second)) {
-    return "";
+    return empty;
   }
   unsigned char x = lower.first + (lower.second ? 0 : 1);
   unsigned char y = upper.first - (upper.second ? 0 : 1);
   if (x > y) {
-    return "";
-  }
-  else if (x == y) {
-    return ap::SymbolChange::getSymbolSet(ap::SymbolChange::getHexSymbol(x));
+    return empty;
   }
   else {
-    return ap::SymbolChange::getSymbolSet(std::make_pair(ap::SymbolChange::getHexSymbol(x), ap::SymbolChange::getHexSymbol(y)));
+    return symbolSetTable()[(x * 256) + y];
   }
 }
 
@@ -83,5 +109,92 @@ getIntervalSymbols(
   return ap::SymbolChange::getSymbolSet(allSymbols);
 }
 
+/**
+ * @brief  Constructor for labeling the given macro element.
+ *
+ * @tparam B          Number of bytes in the limits of the intervals.
+ * @param elementRef  Reference of the macro element which is to be labeled.
+ * @param paramRefs   References of the parameters, indexed by the number of the parameter.
+ * @param changes     Changes to be made in the automaton.
+ */
+template <unsigned B>
+SymbolChangeLabels<B>::SymbolChangeLabels(
+  const ap::ElementRef& elementRef,
+  const ParamRefs& paramRefs,
+  ap::SymbolChange& changes
+) : m_elementRef(elementRef),
+    m_paramRefs(paramRefs),
+    m_changes(changes)
+{
+}
+
+/**
+ * @brief  Function for labeling the given parameter with a single symbol.
+ *
+ * @tparam B      Number of bytes in the limits of the intervals.
+ * @param param   Index of the parameter.
+ * @param symbol  Symbol to be used as the label.
+ */
+template <unsigned B>
+void
+SymbolChangeLabels<B>::add(
+  const unsigned param,
+  const unsigned char symbol
+)
+{
+  m_changes.add(m_elementRef, m_paramRefs[param], symbolSetTable()[(symbol * 256) + symbol]);
+}
+
+/**
+ * @brief  Function for labeling the given parameter with the symbols in a 1-byte interval.
+ *
+ * @tparam B     Number of bytes in the limits of the intervals.
+ * @param param  Index of the parameter.
+ * @param lower  Lower limit of the interval. Setting the bool flag to true means that the limit is inclusive.
+ * @param upper  Upper limit of the interval. Setting the bool flag to true means that the limit is inclusive.
+ */
+template <unsigned B>
+void
+SymbolChangeLabels<B>::add(
+  const unsigned param,
+  const std::pair<unsigned char, bool> lower,
+  const std::pair<unsigned char, bool> upper
+)
+{
+  m_changes.add(m_elementRef, m_paramRefs[param], getIntervalSymbols(lower, upper));
+}
+
+/**
+ * @brief  Function for labeling the given parameter with the symbols in multiple 1-byte intervals.
+ *
+ * @tparam B         Number of bytes in the limits of the intervals.
+ * @param param      Index of the parameter.
+ * @param intervals  List of lower and upper limits for the intervals.
+ */
+template <unsigned B>
+void
+SymbolChangeLabels<B>::add(
+  const unsigned param,
+  const std::vector<std::pair<std::pair<unsigned char, bool>, std::pair<unsigned char, bool> > >& intervals
+)
+{
+  m_changes.add(m_elementRef, m_paramRefs[param], getIntervalSymbols(intervals));
+}
+
+/**
+ * @brief  Default destructor.
+ *
+ * @tparam B  Number of bytes in the limits of the intervals.
+ */
+template <unsigned B>
+SymbolChangeLabels<B>::~SymbolChangeLabels(
+)
+{
+}
+
+// Explicit class instantiation.
+template class SymbolChangeLabels<4>;
+template class SymbolChangeLabels<8>;
+
 //template void assignLabels<float>(const unsigned char* const, const unsigned char* const, const ap::ElementRef&, const std::unordered_map<unsigned, ap::AnmlMacro::ParamRef>&, ap::SymbolChange&);
 //template void assignLabels<double>(const unsigned char* const, const unsigned char* const, const ap::ElementRef&, const std::unordered_map<unsigned, ap::AnmlMacro::ParamRef>&, ap::SymbolChange&);
@@ -22,121 +22,176 @@
 
 #include "apsdk/SymbolChange.hpp"
 
+#include <array>
 #include <sstream>
-#include <unordered_map>
+#include <string>
+#include <vector>
 
 
-std::string
+const std::string&
 getIntervalSymbols(const std::pair<unsigned char, bool>, const std::pair<unsigned char, bool>);
 
 std::string
 getIntervalSymbols(const std::vector<std::pair<std::pair<unsigned char, bool>, std::pair<unsigned char, bool> > >);
 
 
+/**
+ * @brief  Class for adding the labels of a comparator macro as symbol changes in the automaton.
+ *
+ * @tparam B  Number of bytes in the limits of the intervals.
+ *
+ * The references of the macro parameters are stored in an array indexed by the number of the parameter.
+ * The symbol sets are taken from a table which is computed once for all the byte ranges,
+ * so that labeling a macro doesn't build any strings, except for the first byte of signed intervals
+ * which cross zero.
+ */
 template <unsigned B>
+class SymbolChangeLabels {
+public:
+  // References of the parameters %p1 to %p(4B-1), indexed by the number of the parameter.
+  typedef std::array<ap::AnmlMacro::ParamRef, 4*B> ParamRefs;
+
+public:
+  SymbolChangeLabels(const ap::ElementRef&, const ParamRefs&, ap::SymbolChange&);
+
+  void
+  add(const unsigned, const unsigned char);
+
+  void
+  add(const unsigned, const std::pair<unsigned char, bool>, const std::pair<unsigned char, bool>);
+
+  void
+  add(const unsigned, const std::vector<std::pair<std::pair<unsigned char, bool>, std::pair<unsigned char, bool> > >&);
+
+  ~SymbolChangeLabels();
+
+private:
+  const ap::ElementRef& m_elementRef;
+  const ParamRefs& m_paramRefs;
+  ap::SymbolChange& m_changes;
+}; // class SymbolChangeLabels
+
+
+template <unsigned B, typename Labels>
 void
 labelUnsigned(
   const unsigned char* const x,
   const unsigned char* const y,
-  const ap::ElementRef& elementRef,
-  const std::unordered_map<unsigned, ap::AnmlMacro::ParamRef>& paramRefMap,
-  ap::SymbolChange& changes
+  Labels& labels
 )
 {
-  changes.add(elementRef, paramRefMap.at(2), getIntervalSymbols(std::make_pair(x[0], false), std::make_pair(y[0], false)));
+  labels.add(2, std::make_pair(x[0], false), std::make_pair(y[0], false));
 
   bool equalPrefix = true;
   for (unsigned i = 1; i < (B-1); ++i) {
-    changes.add(elementRef, paramRefMap.at(4*(i-1)+1), ap::SymbolChange::getSymbolSet(ap::SymbolChange::getHexSymbol(x[i-1])));
-    changes.add(elementRef, paramRefMap.at(4*(i-1)+4), ap::SymbolChange::getSymbolSet(ap::SymbolChange::getHexSymbol(y[i-1])));
+    labels.add(4*(i-1)+1, x[i-1]);
+    labels.add(4*(i-1)+4, y[i-1]);
     if (x[i-1] != y[i-1]) {
       equalPrefix = false;
     }
     if (equalPrefix) {
-      changes.add(elementRef, paramRefMap.at(4*i+2), getIntervalSymbols(std::make_pair(x[i], false), std::make_pair(y[i], false)));
-      changes.add(elementRef, paramRefMap.at(4*i+3), getIntervalSymbols(std::make_pair(x[i], false), std::make_pair(y[i], false)));
+      labels.add(4*i+2, std::make_pair(x[i], false), std::make_pair(y[i], false));
+      labels.add(4*i+3, std::make_pair(x[i], false), std::make_pair(y[i], false));
     }
     else {
-      changes.add(elementRef, paramRefMap.at(4*i+2), getIntervalSymbols(std::make_pair(x[i], false), std::make_pair(255, true)));
-      changes.add(elementRef, paramRefMap.at(4*i+3), getIntervalSymbols(std::make_pair(0, true), std::make_pair(y[i], false)));
+      labels.add(4*i+2, std::make_pair(x[i], false), std::make_pair(255, true));
+      labels.add(4*i+3, std::make_pair(0, true), std::make_pair(y[i], false));
     }
   }
-  changes.add(elementRef, paramRefMap.at(4*(B-2)+1), ap::SymbolChange::getSymbolSet(ap::SymbolChange::getHexSymbol(x[B-2])));
-  changes.add(elementRef, paramRefMap.at(4*(B-2)+4), ap::SymbolChange::getSymbolSet(ap::SymbolChange::getHexSymbol(y[B-2])));
+  labels.add(4*(B-2)+1, x[B-2]);
+  labels.add(4*(B-2)+4, y[B-2]);
+  if (x[B-2] != y[B-2]) {
+    equalPrefix = false;
+  }
   if (equalPrefix) {
-    changes.add(elementRef, paramRefMap.at(4*(B-1)+2), getIntervalSymbols(std::make_pair(x[B-1], true), std::make_pair(y[B-1], true)));
-    changes.add(elementRef, paramRefMap.at(4*(B-1)+3), getIntervalSymbols(std::make_pair(x[B-1], true), std::make_pair(y[B-1], true)));
+    labels.add(4*(B-1)+2, std::make_pair(x[B-1], true), std::make_pair(y[B-1], true));
+    labels.add(4*(B-1)+3, std::make_pair(x[B-1], true), std::make_pair(y[B-1], true));
   }
   else {
-    changes.add(elementRef, paramRefMap.at(4*(B-1)+2), getIntervalSymbols(std::make_pair(x[B-1], true), std::make_pair(255, true)));
-    changes.add(elementRef, paramRefMap.at(4*(B-1)+3), getIntervalSymbols(std::make_pair(0, true), std::make_pair(y[B-1], true)));
+    labels.add(4*(B-1)+2, std::make_pair(x[B-1], true), std::make_pair(255, true));
+    labels.add(4*(B-1)+3, std::make_pair(0, true), std::make_pair(y[B-1], true));
   }
 }
 
+/**
+ * @brief  Function for adding label changes which disable a comparator, so that it never reports.
+ *
+ * @tparam Labels  Type of the labels to which the changes are added.
+ * @param labels   Labels of the macro which is to be disabled.
+ *
+ * Only the STEs which start the comparator, i.e., %p1, %p2, and %p4, are labeled with empty symbol sets,
+ * since none of the other STEs can be activated without them.
+ */
+template <typename Labels>
+void
+disableLabels(
+  Labels& labels
+)
+{
+  const std::pair<unsigned char, bool> none(255, false);
+  labels.add(1, none, none);
+  labels.add(2, none, none);
+  labels.add(4, none, none);
+}
+
 /**
  * @brief  Function for adding label changes for the given unsigned integer interval.
  *
  * @tparam LimitType  Datatype of the interval limits.
+ * @tparam Labels     Type of the labels to which the changes are added.
  * @param x           Byte representation of the lower limit of the interval.
  * @param y           Byte representation of the Upper limit of the interval.
- * @param elementRef  Reference of the macro element on which the interval is to be programmed.
- * @param paramRefMap A map from the index of the parameter to the corresponding reference.
- * @param changes     Changes to be made in the automaton.
+ * @param labels      Labels of the macro on which the interval is to be programmed.
  */
-template <typename LimitType>
+template <typename LimitType, typename Labels>
 typename std::enable_if<std::is_unsigned<LimitType>::value && std::is_integral<LimitType>::value, void>::type
 assignLabels(
   const unsigned char* const x,
   const unsigned char* const y,
-  const ap::ElementRef& elementRef,
-  const std::unordered_map<unsigned, ap::AnmlMacro::ParamRef>& paramRefMap,
-  ap::SymbolChange& changes
+  Labels& labels
 )
 {
   const size_t B = sizeof(LimitType);
-  labelUnsigned<B>(x, y, elementRef, paramRefMap, changes);
+  labelUnsigned<B>(x, y, labels);
 }
 
 /**
  * @brief  Function for adding label changes for the given signed integer interval.
  *
  * @tparam LimitType  Datatype of the interval limits.
+ * @tparam Labels     Type of the labels to which the changes are added.
  * @param x           Byte representation of the lower limit of the interval.
  * @param y           Byte representation of the Upper limit of the interval.
- * @param elementRef  Reference of the macro element on which the interval is to be programmed.
- * @param paramRefMap A map from the index of the parameter to the corresponding reference.
- * @param changes     Changes to be made in the automaton.
+ * @param labels      Labels of the macro on which the interval is to be programmed.
  */
-template <typename LimitType>
+template <typename LimitType, typename Labels>
 typename std::enable_if<std::is_signed<LimitType>::value && std::is_integral<LimitType>::value, void>::type
 assignLabels(
   const unsigned char* const x,
   const unsigned char* const y,
-  const ap::ElementRef& elementRef,
-  const std::unordered_map<unsigned, ap::AnmlMacro::ParamRef>& paramRefMap,
-  ap::SymbolChange& changes
+  Labels& labels
 )
 {
   const size_t B = sizeof(LimitType);
   if (((x[0] <= 127) && (y[0] <= 127)) || ((x[0] > 127) && (y[0] > 127))) {
-    labelUnsigned<B>(x, y, elementRef, paramRefMap, changes);
+    labelUnsigned<B>(x, y, labels);
   }
   else {
     std::vector<std::pair<std::pair<unsigned char, bool>, std::pair<unsigned char, bool> > > intervals;
     intervals.push_back(std::make_pair(std::make_pair(x[0], false), std::make_pair(255, true)));
     intervals.push_back(std::make_pair(std::make_pair(0, true), std::make_pair(y[0], false)));
-    changes.add(elementRef, paramRefMap.at(2), getIntervalSymbols(intervals));
+    labels.add(2, intervals);
 
     for (unsigned i = 1; i < (B-1); ++i) {
-      changes.add(elementRef, paramRefMap.at(4*(i-1)+1), ap::SymbolChange::getSymbolSet(ap::SymbolChange::getHexSymbol(x[i-1])));
-      changes.add(elementRef, paramRefMap.at(4*(i-1)+4), ap::SymbolChange::getSymbolSet(ap::SymbolChange::getHexSymbol(y[i-1])));
-      changes.add(elementRef, paramRefMap.at(4*i+2), getIntervalSymbols(std::make_pair(x[i], false), std::make_pair(255, true)));
-      changes.add(elementRef, paramRefMap.at(4*i+3), getIntervalSymbols(std::make_pair(0, true), std::make_pair(y[i], false)));
+      labels.add(4*(i-1)+1, x[i-1]);
+      labels.add(4*(i-1)+4, y[i-1]);
+      labels.add(4*i+2, std::make_pair(x[i], false), std::make_pair(255, true));
+      labels.add(4*i+3, std::make_pair(0, true), std::make_pair(y[i], false));
     }
-    changes.add(elementRef, paramRefMap.at(4*(B-2)+1), ap::SymbolChange::getSymbolSet(ap::SymbolChange::getHexSymbol(x[B-2])));
-    changes.add(elementRef, paramRefMap.at(4*(B-2)+4), ap::SymbolChange::getSymbolSet(ap::SymbolChange::getHexSymbol(y[B-2])));
-    changes.add(elementRef, paramRefMap.at(4*(B-1)+2), getIntervalSymbols(std::make_pair(x[B-1], true), std::make_pair(255, true)));
-    changes.add(elementRef, paramRefMap.at(4*(B-1)+3), getIntervalSymbols(std::make_pair(0, true), std::make_pair(y[B-1], true)));
+    labels.add(4*(B-2)+1, x[B-2]);
+    labels.add(4*(B-2)+4, y[B-2]);
+    labels.add(4*(B-1)+2, std::make_pair(x[B-1], true), std::make_pair(255, true));
+    labels.add(4*(B-1)+3, std::make_pair(0, true), std::make_pair(y[B-1], true));
   }
 }
 
@@ -144,28 +199,25 @@ assignLabels(
  * @brief  Function for adding label changes for the given floating-point interval.
  *
  * @tparam LimitType  Datatype of the interval limits.
+ * @tparam Labels     Type of the labels to which the changes are added.
  * @param x           Byte representation of the lower limit of the interval.
  * @param y           Byte representation of the Upper limit of the interval.
- * @param elementRef  Reference of the macro element on which the interval is to be programmed.
- * @param paramRefMap A map from the index of the parameter to the corresponding reference.
- * @param changes     Changes to be made in the automaton.
+ * @param labels      Labels of the macro on which the interval is to be programmed.
  */
-template <typename LimitType>
+template <typename LimitType, typename Labels>
 typename std::enable_if<std::is_floating_point<LimitType>::value, void>::type
 assignLabels(
   const unsigned char* const x,
   const unsigned char* const y,
-  const ap::ElementRef& elementRef,
-  const std::unordered_map<unsigned, ap::AnmlMacro::ParamRef>& paramRefMap,
-  ap::SymbolChange& changes
+  Labels& labels
 )
 {
   const size_t B = sizeof(LimitType);
   if ((x[0] <= 127) && (y[0] <= 127)) {
-    labelUnsigned<B>(x, y, elementRef, paramRefMap, changes);
+    labelUnsigned<B>(x, y, labels);
   }
   else if ((x[0] > 127) && (y[0] > 127)) {
-    labelUnsigned<B>(y, x, elementRef, paramRefMap, changes);
+    labelUnsigned<B>(y, x, labels);
   }
   else {
     std::stringstream ss;
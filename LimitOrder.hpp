@@ -0,0 +1,61 @@
+/**
+ * @file LimitOrder.hpp
+ * @brief Declaration of functions for comparing limits in the order of the comparators.
+ * @author Ankit Srivastava <asrivast@gatech.edu>
+ *
+ * Copyright 2018 Georgia Institute of Technology
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef LIMITORDER_HPP_
+#define LIMITORDER_HPP_
+
+#include <cmath>
+#include <type_traits>
+
+
+/**
+ * @brief  Function for checking if an integer limit is before another.
+ */
+template <typename LimitType>
+inline
+typename std::enable_if<!std::is_floating_point<LimitType>::value, bool>::type
+limitLess(
+  const LimitType a,
+  const LimitType b
+)
+{
+  return (a < b);
+}
+
+/**
+ * @brief  Function for checking if a real limit is before another, in the order in which the comparators
+ *         on the AP compare them.
+ *
+ * The comparators compare the signs first, so all the negative numbers, including -0.0, are before
+ * all the positive numbers, including +0.0. Numbers with the same sign are compared numerically.
+ * Hence, -0.0 and +0.0 stab only the halves of a split interval which have the same sign.
+ */
+template <typename LimitType>
+inline
+typename std::enable_if<std::is_floating_point<LimitType>::value, bool>::type
+limitLess(
+  const LimitType a,
+  const LimitType b
+)
+{
+  const bool negative = std::signbit(a);
+  return (negative != std::signbit(b)) ? negative : (a < b);
+}
+
+#endif // LIMITORDER_HPP_
@@ -0,0 +1,92 @@
+/**
+ * @file Parallel.hpp
+ * @brief Implementation of helper functions for running work on multiple threads.
+ * @author Ankit Srivastava <asrivast@gatech.edu>
+ *
+ * Copyright 2018 Georgia Institute of Technology
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef PARALLEL_HPP_
+#define PARALLEL_HPP_
+
+#include <exception>
+#include <thread>
+#include <vector>
+
+
+/**
+ * @brief  Function for getting the number of threads to be used.
+ *
+ * @param numThreads  Requested number of threads. 0 means one thread per hardware thread.
+ *
+ * @return  The number of threads, which is at least one.
+ */
+inline
+unsigned
+getNumThreads(
+  const unsigned numThreads
+)
+{
+  if (numThreads > 0) {
+    return numThreads;
+  }
+  unsigned hardwareThreads = std::thread::hardware_concurrency();
+  return (hardwareThreads > 0) ? hardwareThreads : 1;
+}
+
+/**
+ * @brief  Function for splitting items into contiguous ranges and processing every range on its own thread.
+ *
+ * @tparam Function   Type of the function which processes one range.
+ * @param numThreads  Number of threads, and therefore the number of ranges.
+ * @param count       Total number of items.
+ * @param function    Function called as function(t, first, last) for the items in [first, last) of the t-th range.
+ *
+ * The first range is processed on the calling thread. If any of the calls throw,
+ * the exception from the lowest range is rethrown after all the threads have finished.
+ */
+template <typename Function>
+void
+parallelFor(
+  const unsigned numThreads,
+  const size_t count,
+  Function function
+)
+{
+  std::vector<std::exception_ptr> errors(numThreads);
+  auto process = [&](const unsigned t)
+                 {
+                   try {
+                     function(t, (count * t) / numThreads, (count * (t + 1)) / numThreads);
+                   }
+                   catch (...) {
+                     errors[t] = std::current_exception();
+                   }
+                 };
+  std::vector<std::thread> threads;
+  for (unsigned t = 1; t < numThreads; ++t) {
+    threads.push_back(std::thread(process, t));
+  }
+  process(0);
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  for (const std::exception_ptr& error : errors) {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+}
+
+#endif // PARALLEL_HPP_
@@ -19,13 +19,14 @@
  */
 #include "Points.hpp"
 
+#include "Profiler.hpp"
+#include "TextParser.hpp"
+
 #include <cstdint>
-#include <fstream>
-#include <iostream>
-#include <random>
-#include <sstream>
 #include <stdexcept>
 
+#include <boost/filesystem.hpp>
+
 
 /**
  * @brief  Default constructor for empty initialization.
@@ -34,99 +35,153 @@
  */
 template <typename PointType>
 Points<PointType>::Points(
-) : m_points()
+) : m_points(),
+    m_file(),
+    m_data(nullptr),
+    m_count(0)
 {
 }
 
 /**
  * @brief  Constructor for reading the points from the given file.
+ *         Files in the binary format are memory mapped instead of being read.
  *
  * @tparam PointType   Datatype of the points.
  * @param  pointsFile  Name of the file from which points are to be read.
+ * @param  numThreads  Number of threads to be used for parsing a text file.
  */
 template <typename PointType>
 Points<PointType>::Points(
-  const std::string& pointsFile
-) : m_points()
+  const std::string& pointsFile,
+  const unsigned numThreads
+) : m_points(),
+    m_file(),
+    m_data(nullptr),
+    m_count(0)
 {
-  std::ifstream points(pointsFile);
-  std::string line;
-  while (std::getline(points, line)) {
-    std::istringstream is(line);
-    PointType z;
-    is >> z;
-    m_points.push_back(z);
+  ProfiledPhase parse("parse_points");
+  if (BinaryFile::isBinary(pointsFile)) {
+    m_file = std::make_shared<BinaryFile>(pointsFile, binaryType<PointType>(), 1);
+  }
+  else {
+    parseTextFile(pointsFile, numThreads, m_points);
   }
+  setData();
+  parse.addBytes(boost::filesystem::file_size(pointsFile));
+}
+
+/**
+ * @brief  Constructor for taking over the given points.
+ *
+ * @tparam PointType  Datatype of the points.
+ * @param  points     Points to be stored.
+ */
+template <typename PointType>
+Points<PointType>::Points(
+  std::vector<PointType>&& points
+) : m_points(std::move(points)),
+    m_file(),
+    m_data(nullptr),
+    m_count(0)
+{
+  setData();
+}
+
+/**
+ * @brief  Copy constructor.
+ *
+ * @tparam PointType  Datatype of the points.
+ * @param  other      Points to be copied. Memory mapped points are shared.
+ */
+template <typename PointType>
+Points<PointType>::Points(
+  const Points& other
+) : m_points(other.m_points),
+    m_file(other.m_file),
+    m_data(nullptr),
+    m_count(0)
+{
+  setData();
 }
 
 /**
- * @brief  Constructor for generating random points.
+ * @brief  Move constructor.
  *
- * @tparam PointType              Datatype of the points.
- * @tparam RandomNumberGenerator  Type of the random number generator. 
- * @param  numRandom              Number of random points to be generated.
- * @param  generator              Instance of the random number generator. 
+ * @tparam PointType  Datatype of the points.
+ * @param  other      Points to be moved, without copying the stored points.
  */
 template <typename PointType>
-template <typename RandomNumberGenerator>
 Points<PointType>::Points(
-  const size_t,
-  RandomNumberGenerator&
-) : m_points()
+  Points&& other
+) : m_points(std::move(other.m_points)),
+    m_file(std::move(other.m_file)),
+    m_data(nullptr),
+    m_count(0)
 {
-  throw std::runtime_error("Random generation of points hasn't been implemented for the datatype.");
+  setData();
+  other.setData();
 }
 
-// Specialization of the random point generator constructor for integer datatypes.
-#define INITIALIZE_INTEGER(IntegerType) \
-template <> \
-template <typename RandomNumberGenerator> \
-Points<IntegerType>::Points( \
-  const size_t numRandom, \
-  RandomNumberGenerator& generator \
-) : m_points() \
-{ \
-  IntegerType lower = std::numeric_limits<IntegerType>::min(); \
-  IntegerType upper = std::numeric_limits<IntegerType>::max(); \
-  std::uniform_int_distribution<IntegerType> distribution(lower, upper); \
-  std::cout << "Following are the randomly generated points:" << std::endl; \
-  for (size_t i = 0; i < numRandom; ++i) { \
-    IntegerType z = distribution(generator); \
-    std::cout << z << std::endl; \
-    m_points.push_back(z); \
-  } \
-  std::cout << std::endl; \
+/**
+ * @brief  Copy assignment operator.
+ *
+ * @tparam PointType  Datatype of the points.
+ * @param  other      Points to be copied. Memory mapped points are shared.
+ *
+ * @return  A reference to the points.
+ */
+template <typename PointType>
+Points<PointType>&
+Points<PointType>::operator=(
+  const Points& other
+)
+{
+  m_points = other.m_points;
+  m_file = other.m_file;
+  setData();
+  return *this;
 }
 
-INITIALIZE_INTEGER(uint32_t);
-INITIALIZE_INTEGER(int32_t);
-INITIALIZE_INTEGER(uint64_t);
-INITIALIZE_INTEGER(int64_t);
-
-// Specialization of the random point generator constructor for real datatypes.
-#define INITIALIZE_REAL(RealType) \
-template <> \
-template <typename RandomNumberGenerator> \
-Points<RealType>::Points( \
-  const size_t numRandom, \
-  RandomNumberGenerator& generator \
-) : m_points() \
-{ \
-  RealType lower = std::numeric_limits<RealType>::min(); \
-  RealType upper = std::numeric_limits<RealType>::max(); \
-  std::default_random_engine generator(seed); \
-  std::uniform_real_distribution<RealType> distribution(lower, upper); \
-  std::cout << "Following are the randomly generated points:" << std::endl; \
-  for (size_t i = 0; i < numRandom; ++i) { \
-    RealType z = distribution(generator); \
-    std::cout << z << std::endl; \
-    m_points.push_back(z); \
-  } \
-  std::cout << std::endl; \
+/**
+ * @brief  Move assignment operator.
+ *
+ * @tparam PointType  Datatype of the points.
+ * @param  other      Points to be moved, without copying the stored points.
+ *
+ * @return  A reference to the points.
+ */
+template <typename PointType>
+Points<PointType>&
+Points<PointType>::operator=(
+  Points&& other
+)
+{
+  m_points = std::move(other.m_points);
+  m_file = std::move(other.m_file);
+  setData();
+  other.setData();
+  return *this;
 }
 
-//INITIALIZE_REAL(float);
-//INITIALIZE_REAL(double);
+/**
+ * @brief  Function for pointing to the points, either in the memory mapped file or in the container.
+ *
+ * @tparam PointType  Datatype of the points.
+ */
+template <typename PointType>
+void
+Points<PointType>::setData(
+)
+{
+  if (m_file) {
+    m_data = static_cast<const PointType*>(m_file->data());
+    m_count = m_file->count();
+  }
+  else {
+    m_data = m_points.data();
+    m_count = m_points.size();
+  }
+}
 
 /**
  * @brief  Function for accessing the point at a given index.
@@ -142,7 +197,22 @@ Points<PointType>::get(
   const size_t index
 ) const
 {
-  return m_points[index];
+  return m_data[index];
+}
+
+/**
+ * @brief  Function for accessing all the points.
+ *
+ * @tparam PointType  Datatype of the points.
+ *
+ * @return  Pointer to the first of the points, which are stored contiguously.
+ */
+template <typename PointType>
+const PointType*
+Points<PointType>::data(
+) const
+{
+  return m_data;
 }
 
 /**
@@ -157,7 +227,22 @@ size_t
 Points<PointType>::count(
 ) const
 {
-  return m_points.size();
+  return m_count;
+}
+
+/**
+ * @brief  Function for writing the points to a file in the binary format.
+ *
+ * @tparam PointType  Datatype of the points.
+ * @param  fileName   Name of the file to be written.
+ */
+template <typename PointType>
+void
+Points<PointType>::save(
+  const std::string& fileName
+) const
+{
+  BinaryFile::write(fileName, binaryType<PointType>(), 1, m_data, sizeof(PointType), m_count);
 }
 
 /**
@@ -178,10 +263,3 @@ template class Points<uint64_t>;
 template class Points<int64_t>;
 template class Points<float>;
 template class Points<double>;
-
-template Points<uint32_t>::Points(const size_t, std::default_random_engine&);
-template Points<int32_t>::Points(const size_t, std::default_random_engine&);
-template Points<uint64_t>::Points(const size_t, std::default_random_engine&);
-template Points<int64_t>::Points(const size_t, std::default_random_engine&);
-template Points<float>::Points(const size_t, std::default_random_engine&);
-template Points<double>::Points(const size_t, std::default_random_engine&);
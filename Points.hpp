@@ -20,6 +20,9 @@
 #ifndef POINTS_HPP_
 #define POINTS_HPP_
 
+#include "BinaryFile.hpp"
+
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -34,21 +37,43 @@ class Points {
 public:
   Points();
 
-  Points(const std::string&);
+  Points(const std::string&, const unsigned);
+
+  Points(std::vector<PointType>&&);
+
+  Points(const Points&);
+
+  Points(Points&&);
+
+  Points&
+  operator=(const Points&);
 
-  template <typename RandomNumberGenerator>
-  Points(const size_t, RandomNumberGenerator&); 
+  Points&
+  operator=(Points&&);
 
   const PointType&
   get(const size_t) const;
 
+  const PointType*
+  data() const;
+
   size_t
   count() const;
 
+  void
+  save(const std::string&) const;
+
   ~Points();
 
+private:
+  void
+  setData();
+
 private:
   std::vector<PointType> m_points;
+  std::shared_ptr<BinaryFile> m_file;
+  const PointType* m_data;
+  size_t m_count;
 };
 
 #endif // POINTS_HPP_ 
@@ -0,0 +1,260 @@
+/**
+ * @file Profiler.cpp
+ * @brief Implementation of Profiler functions.
+ * @author Ankit Srivastava <asrivast@gatech.edu>
+ *
+ * Copyright 2018 Georgia Institute of Technology
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "Profiler.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <time.h>
+
+
+/**
+ * @brief  Totals of a phase.
+ */
+struct PhaseTotals {
+  size_t calls;
+  double wallSeconds;
+  double cpuSeconds;
+  size_t bytes;
+};
+
+// State of the profiler, which is shared by all the threads.
+static bool profilerEnabled = false;
+static std::mutex profilerMutex;
+static std::chrono::steady_clock::time_point profilerWallStart;
+static double profilerCpuStart = 0.0;
+// Phases and counters, in the order in which they were first added.
+static std::vector<std::pair<std::string, PhaseTotals> > profilerPhases;
+static std::vector<std::pair<std::string, size_t> > profilerCounters;
+
+/**
+ * @brief  Function for finding an entry by its name, and adding it if it doesn't exist.
+ *
+ * @tparam ValueType  Type of the values of the entries.
+ * @param entries     Entries in which the name is to be found.
+ * @param name        Name of the entry.
+ * @param initial     Value of the entry, if it is added.
+ */
+template <typename ValueType>
+static
+ValueType&
+findEntry(
+  std::vector<std::pair<std::string, ValueType> >& entries,
+  const std::string& name,
+  const ValueType& initial
+)
+{
+  for (std::pair<std::string, ValueType>& entry : entries) {
+    if (entry.first == name) {
+      return entry.second;
+    }
+  }
+  entries.push_back(std::make_pair(name, initial));
+  return entries.back().second;
+}
+
+/**
+ * @brief  Function for enabling profiling, which also starts the timing of the whole run.
+ */
+void
+Profiler::enable(
+)
+{
+  profilerWallStart = std::chrono::steady_clock::now();
+  profilerCpuStart = cpuSeconds();
+  profilerEnabled = true;
+}
+
+/**
+ * @brief  Function for checking if profiling is enabled.
+ */
+bool
+Profiler::enabled(
+)
+{
+  return profilerEnabled;
+}
+
+/**
+ * @brief  Function for adding one call of a phase to its totals.
+ *
+ * @param name         Name of the phase.
+ * @param wallSeconds  Wall time taken by the call.
+ * @param cpuSeconds   CPU time of the process taken by the call.
+ * @param bytes        Number of bytes processed by the call.
+ */
+void
+Profiler::addPhase(
+  const std::string& name,
+  const double wallSeconds,
+  const double cpuSeconds,
+  const size_t bytes
+)
+{
+  std::lock_guard<std::mutex> lock(profilerMutex);
+  PhaseTotals& totals = findEntry(profilerPhases, name, PhaseTotals{0, 0.0, 0.0, 0});
+  ++totals.calls;
+  totals.wallSeconds += wallSeconds;
+  totals.cpuSeconds += cpuSeconds;
+  totals.bytes += bytes;
+}
+
+/**
+ * @brief  Function for adding to a counter.
+ *
+ * @param name   Name of the counter.
+ * @param count  Number to be added.
+ */
+void
+Profiler::addCount(
+  const std::string& name,
+  const size_t count
+)
+{
+  if (!profilerEnabled) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(profilerMutex);
+  findEntry(profilerCounters, name, static_cast<size_t>(0)) += count;
+}
+
+/**
+ * @brief  Function for raising a counter to the given value, if it is smaller.
+ *
+ * @param name   Name of the counter.
+ * @param value  Value to which the counter is raised.
+ */
+void
+Profiler::setMaximum(
+  const std::string& name,
+  const size_t value
+)
+{
+  if (!profilerEnabled) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(profilerMutex);
+  size_t& counter = findEntry(profilerCounters, name, static_cast<size_t>(0));
+  counter = std::max(counter, value);
+}
+
+/**
+ * @brief  Function for writing the report of the run to the given file, in the JSON format.
+ *
+ * @param fileName  Name of the file to be written.
+ */
+void
+Profiler::write(
+  const std::string& fileName
+)
+{
+  std::lock_guard<std::mutex> lock(profilerMutex);
+  std::ofstream file(fileName);
+  double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - profilerWallStart).count();
+  file << "{\n  \"wall_seconds\": " << wallSeconds << ",\n  \"cpu_seconds\": " << (cpuSeconds() - profilerCpuStart) << ",\n  \"phases\": {";
+  for (size_t p = 0; p < profilerPhases.size(); ++p) {
+    const PhaseTotals& totals = profilerPhases[p].second;
+    file << ((p > 0) ? ",\n" : "\n") << "    \"" << profilerPhases[p].first << "\": {\"calls\": " << totals.calls
+         << ", \"wall_seconds\": " << totals.wallSeconds << ", \"cpu_seconds\": " << totals.cpuSeconds
+         << ", \"bytes\": " << totals.bytes << "}";
+  }
+  file << "\n  },\n  \"counters\": {";
+  for (size_t c = 0; c < profilerCounters.size(); ++c) {
+    file << ((c > 0) ? ",\n" : "\n") << "    \"" << profilerCounters[c].first << "\": " << profilerCounters[c].second;
+  }
+  file << "\n  }\n}" << std::endl;
+  if (!file) {
+    throw std::runtime_error("Couldn't write the profile to the file " + fileName + ".");
+  }
+}
+
+/**
+ * @brief  Function for getting the CPU time used by the process so far, in seconds.
+ */
+double
+Profiler::cpuSeconds(
+)
+{
+  struct timespec time;
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &time);
+  return time.tv_sec + (time.tv_nsec * 1e-9);
+}
+
+/**
+ * @brief  Constructor for starting the timing of a phase.
+ *
+ * @param name   Name of the phase, which must outlive the timing.
+ * @param bytes  Number of bytes processed by the phase, if already known.
+ */
+ProfiledPhase::ProfiledPhase(
+  const char* const name,
+  const size_t bytes
+) : m_name(name),
+    m_bytes(bytes),
+    m_enabled(Profiler::enabled()),
+    m_wallStart(),
+    m_cpuStart(0.0)
+{
+  if (m_enabled) {
+    m_wallStart = std::chrono::steady_clock::now();
+    m_cpuStart = Profiler::cpuSeconds();
+  }
+}
+
+/**
+ * @brief  Function for adding to the number of bytes processed by the phase.
+ *
+ * @param bytes  Number of bytes to be added.
+ */
+void
+ProfiledPhase::addBytes(
+  const size_t bytes
+)
+{
+  m_bytes += bytes;
+}
+
+/**
+ * @brief  Function for ending the timing of the phase before its destruction,
+ *         and adding it to the totals of the phase.
+ */
+void
+ProfiledPhase::stop(
+)
+{
+  if (m_enabled) {
+    double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_wallStart).count();
+    Profiler::addPhase(m_name, wallSeconds, Profiler::cpuSeconds() - m_cpuStart, m_bytes);
+    m_enabled = false;
+  }
+}
+
+/**
+ * @brief  Destructor, which ends the timing of the phase if it hasn't been stopped.
+ */
+ProfiledPhase::~ProfiledPhase(
+)
+{
+  stop();
+}
@@ -0,0 +1,97 @@
+/**
+ * @file Profiler.hpp
+ * @brief Declaration of Profiler functions.
+ * @author Ankit Srivastava <asrivast@gatech.edu>
+ *
+ * Copyright 2018 Georgia Institute of Technology
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef PROFILER_HPP_
+#define PROFILER_HPP_
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+
+
+/**
+ * @brief  Class for collecting the time spent in the phases of a run, along with a few counters.
+ *
+ * Profiling is disabled unless it is enabled before the run starts, in which case every phase adds
+ * its wall time, the CPU time of the process, and the number of bytes it processed to the totals
+ * of the phase. The CPU time is that of the whole process, and therefore also includes the time spent
+ * by any other phases which overlap the phase, e.g., in the pipeline of the AP engine.
+ * Phases and counters can be added from many threads.
+ */
+class Profiler {
+public:
+  static
+  void
+  enable();
+
+  static
+  bool
+  enabled();
+
+  static
+  void
+  addPhase(const std::string&, const double, const double, const size_t);
+
+  static
+  void
+  addCount(const std::string&, const size_t);
+
+  static
+  void
+  setMaximum(const std::string&, const size_t);
+
+  static
+  void
+  write(const std::string&);
+
+  static
+  double
+  cpuSeconds();
+}; // class Profiler
+
+/**
+ * @brief  Class for timing one phase of a run, from its creation to its destruction, if profiling is enabled.
+ */
+class ProfiledPhase {
+public:
+  ProfiledPhase(const char* const, const size_t = 0);
+
+  void
+  addBytes(const size_t);
+
+  void
+  stop();
+
+  ~ProfiledPhase();
+
+private:
+  ProfiledPhase(const ProfiledPhase&);
+
+  ProfiledPhase&
+  operator=(const ProfiledPhase&);
+
+private:
+  const char* const m_name;
+  size_t m_bytes;
+  bool m_enabled;
+  std::chrono::steady_clock::time_point m_wallStart;
+  double m_cpuStart;
+}; // class ProfiledPhase
+
+#endif // PROFILER_HPP_
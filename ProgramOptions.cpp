@@ -27,30 +27,75 @@
 
 ProgramOptions::ProgramOptions(
 ) : m_options("Determines which of the given intervals were stabbed by the given points"),
-    m_deviceName(),
+    m_engine(),
+    m_mode(),
+    m_format(),
+    m_outputFile(),
+    m_deviceNames(),
+    m_sharding(),
     m_macrosDir(),
     m_fsmName(),
+    m_cacheDir(),
     m_intervalsFile(),
-    m_pointsFile(),
+    m_pointsFiles(),
+    m_queriesFiles(),
+    m_saveIntervalsFile(),
+    m_savePointsFile(),
+    m_updatesFile(),
+    m_profileFile(),
     m_numBytes(),
+    m_numDimensions(),
     m_randomSeed(),
     m_numIntervals(),
     m_numPoints(),
+    m_lengths(),
+    m_meanLength(),
+    m_stabDensity(),
+    m_locations(),
+    m_numClusters(),
+    m_zipfExponent(),
+    m_maxComparators(),
+    m_numSpares(),
+    m_maxChunkSize(),
+    m_numThreads(),
     m_isReal(),
-    m_isSigned()
+    m_isSigned(),
+    m_indicesOnly()
 {
   m_options.add_options()
     ("help,h", "Print this message.")
-    ("device,d", po::value<std::string>(&m_deviceName), "Name of the AP device to be used for stabbing intervals.")
+    ("engine,e", po::value<std::string>(&m_engine)->default_value("ap"), "Engine to be used for stabbing intervals (ap, tree, sweep).")
+    ("mode", po::value<std::string>(&m_mode)->default_value("list"), "Result of stabbing for every point (list of the stabbed intervals, count of the stabbed intervals, any interval stabbed).")
+    ("format", po::value<std::string>(&m_format)->default_value("text"), "Format of the results (text table, tsv pairs of indices, binary pairs of 8-byte indices).")
+    ("output,o", po::value<std::string>(&m_outputFile), "Name of the file to which the results are to be written (the standard output if not given).")
+    ("indices", po::bool_switch(&m_indicesOnly)->default_value(false), "Print the indices of the stabbed intervals instead of their limits, in the text format.")
+    ("device,d", po::value<std::vector<std::string> >(&m_deviceNames)->multitoken(), "Names of the AP devices to be used for stabbing intervals (simulator for simulating a device on the CPU).")
+    ("sharding", po::value<std::string>(&m_sharding)->default_value("auto"), "How the work is split between the AP devices (auto, intervals, points).")
     ("macros,m", po::value<std::string>(&m_macrosDir)->default_value("./comparators"), "Directory which contains all the comparator macros.")
     ("fsm,f", po::value<std::string>(&m_fsmName), "Name of the FSM file to be written.")
+    ("cache,C", po::value<std::string>(&m_cacheDir), "Directory in which compiled automata are cached.")
     ("intervals,i", po::value<std::string>(&m_intervalsFile), "Name of the file from which intervals are to be read.")
-    ("points,p", po::value<std::string>(&m_pointsFile), "Name of the file from which points are to be read.")
+    ("points,p", po::value<std::vector<std::string> >(&m_pointsFiles), "Name of the file from which points are to be read. Every file is stabbed as a separate batch of points.")
+    ("queries,q", po::value<std::vector<std::string> >(&m_queriesFiles), "Name of the file from which query intervals are to be read, for finding the intervals overlapping every query. Every file is queried as a separate batch.")
+    ("save-intervals", po::value<std::string>(&m_saveIntervalsFile), "Name of the binary file to which the intervals are to be saved, without stabbing.")
+    ("save-points", po::value<std::string>(&m_savePointsFile), "Name of the binary file to which the points are to be saved, without stabbing.")
+    ("updates", po::value<std::string>(&m_updatesFile), "Name of the file from which updates to the intervals are to be read, one per line (\"+ lower upper\" for inserting, \"- index\" for erasing).")
+    ("profile", po::value<std::string>(&m_profileFile), "Name of the file to which the time spent in every phase of the run, along with some counters, is to be written in the JSON format.")
     ("bytes,b", po::value<size_t>(&m_numBytes)->default_value(4), "Number of bytes.")
+    ("dimensions", po::value<unsigned>(&m_numDimensions)->default_value(1), "Number of dimensions (1 for intervals, 2 or 3 for boxes with one interval per dimension).")
     ("seed,s", po::value<size_t>(&m_randomSeed)->default_value(0), "Seed for random number generator.")
     ("random-intervals,I", po::value<size_t>(&m_numIntervals)->default_value(0), "Number of random intervals to be programmed.")
     ("random-points,P", po::value<size_t>(&m_numPoints)->default_value(0), "Number of random points to be used for stabbing.")
+    ("lengths", po::value<std::string>(&m_lengths)->default_value("uniform"), "Distribution of the lengths of the random intervals (uniform limits, fixed, exponential).")
+    ("mean-length", po::value<double>(&m_meanLength)->default_value(0.0), "Mean length of the random intervals, for fixed and exponential lengths.")
+    ("stab-density", po::value<double>(&m_stabDensity)->default_value(0.0), "Expected number of random intervals stabbed by a uniformly located point, used for deriving the mean length.")
+    ("locations", po::value<std::string>(&m_locations)->default_value("uniform"), "Distribution of the locations of the random points (uniform, clustered, zipf).")
+    ("clusters", po::value<size_t>(&m_numClusters)->default_value(16), "Number of clusters of the random points, for clustered locations.")
+    ("zipf-exponent", po::value<double>(&m_zipfExponent)->default_value(1.0), "Exponent of the Zipfian distribution of the random points, for zipf locations.")
+    ("max-comparators", po::value<size_t>(&m_maxComparators)->default_value(0), "Maximum number of comparators in one automaton (0 for an estimate of the capacity of the board).")
+    ("spare-comparators", po::value<size_t>(&m_numSpares)->default_value(0), "Number of spare comparators, on which inserted intervals are programmed.")
     ("chunks,c", po::value<size_t>(&m_maxChunkSize)->default_value(std::numeric_limits<size_t>::max()), "Maximum chunk size for flows to the AP.")
+    ("threads,t", po::value<unsigned>(&m_numThreads)->default_value(1), "Number of threads to be used on the host (0 for all the hardware threads).")
     ("real", po::bool_switch(&m_isReal)->default_value(false), "Use real numbers for labeling.")
     ("signed", po::bool_switch(&m_isSigned)->default_value(false), "Use signed numbers for labeling.")
     ;
@@ -71,25 +116,107 @@ ProgramOptions::parse(
     ss << m_options;
     throw po::error(ss.str());
   }
+  if ((m_engine != "ap") && (m_engine != "tree") && (m_engine != "sweep")) {
+    throw po::error("Unsupported engine.");
+  }
+  if ((m_mode != "list") && (m_mode != "count") && (m_mode != "any")) {
+    throw po::error("Unsupported mode.");
+  }
+  if ((m_format != "text") && (m_format != "tsv") && (m_format != "binary")) {
+    throw po::error("Unsupported format of the results.");
+  }
+  if ((m_format == "binary") && m_outputFile.empty()) {
+    throw po::error("Binary results must be written to a file given using --output.");
+  }
+  if ((m_lengths != "uniform") && (m_lengths != "fixed") && (m_lengths != "exponential")) {
+    throw po::error("Unsupported distribution of the lengths.");
+  }
+  if ((m_lengths != "uniform") && !(m_meanLength > 0.0) && !(m_stabDensity > 0.0)) {
+    throw po::error("Either \"mean-length\" or \"stab-density\" should be positive for fixed and exponential lengths.");
+  }
+  if ((m_locations != "uniform") && (m_locations != "clustered") && (m_locations != "zipf")) {
+    throw po::error("Unsupported distribution of the locations.");
+  }
+  if ((m_locations == "clustered") && (m_numClusters == 0)) {
+    throw po::error("At least one cluster is needed for clustered locations.");
+  }
+  if ((m_numDimensions < 1) || (m_numDimensions > 3)) {
+    throw po::error("Unsupported number of dimensions.");
+  }
+  if ((m_sharding != "auto") && (m_sharding != "intervals") && (m_sharding != "points")) {
+    throw po::error("Unsupported sharding.");
+  }
   if (!m_intervalsFile.empty() && !boost::filesystem::exists(boost::filesystem::path(m_intervalsFile))) {
     throw po::error("Couldn't find the intervals file.");
   }
-  if (!m_pointsFile.empty() && !boost::filesystem::exists(boost::filesystem::path(m_pointsFile))) {
-    throw po::error("Couldn't find the points file.");
+  for (const std::string& queriesFile : m_queriesFiles) {
+    if (!boost::filesystem::exists(boost::filesystem::path(queriesFile))) {
+      throw po::error("Couldn't find the queries file " + queriesFile + ".");
+    }
+  }
+  if (!m_updatesFile.empty() && !boost::filesystem::exists(boost::filesystem::path(m_updatesFile))) {
+    throw po::error("Couldn't find the updates file.");
+  }
+  for (const std::string& pointsFile : m_pointsFiles) {
+    if (!boost::filesystem::exists(boost::filesystem::path(pointsFile))) {
+      throw po::error("Couldn't find the points file " + pointsFile + ".");
+    }
   }
   if ((!m_intervalsFile.empty()) && (m_numIntervals > 0)) {
     std::cerr << "WARNING: \"intervals\" and \"random-intervals\" argument provided together. \"random-intervals\" will be ignored." << std::endl;
   }
-  if ((!m_pointsFile.empty()) && (m_numPoints > 0)) {
+  if ((!m_pointsFiles.empty()) && (m_numPoints > 0)) {
     std::cerr << "WARNING: \"points\" and \"random-points\" argument provided together. \"random-points\" will be ignored." << std::endl;
   }
 }
 
 std::string
-ProgramOptions::deviceName(
+ProgramOptions::engine(
 ) const
 {
-  return m_deviceName;
+  return m_engine;
+}
+
+std::string
+ProgramOptions::mode(
+) const
+{
+  return m_mode;
+}
+
+std::string
+ProgramOptions::format(
+) const
+{
+  return m_format;
+}
+
+std::string
+ProgramOptions::outputFile(
+) const
+{
+  return m_outputFile;
+}
+
+bool
+ProgramOptions::indicesOnly(
+) const
+{
+  return m_indicesOnly;
+}
+
+const std::vector<std::string>&
+ProgramOptions::deviceNames(
+) const
+{
+  return m_deviceNames;
+}
+
+std::string
+ProgramOptions::sharding(
+) const
+{
+  return m_sharding;
 }
 
 std::string
@@ -106,6 +233,13 @@ ProgramOptions::fsmName(
   return m_fsmName;
 }
 
+std::string
+ProgramOptions::cacheDir(
+) const
+{
+  return m_cacheDir;
+}
+
 std::string
 ProgramOptions::intervalsFile(
 ) const
@@ -113,11 +247,46 @@ ProgramOptions::intervalsFile(
   return m_intervalsFile;
 }
 
+const std::vector<std::string>&
+ProgramOptions::pointsFiles(
+) const
+{
+  return m_pointsFiles;
+}
+
+const std::vector<std::string>&
+ProgramOptions::queriesFiles(
+) const
+{
+  return m_queriesFiles;
+}
+
+std::string
+ProgramOptions::saveIntervalsFile(
+) const
+{
+  return m_saveIntervalsFile;
+}
+
+std::string
+ProgramOptions::savePointsFile(
+) const
+{
+  return m_savePointsFile;
+}
+
 std::string
-ProgramOptions::pointsFile(
+ProgramOptions::updatesFile(
 ) const
 {
-  return m_pointsFile;
+  return m_updatesFile;
+}
+
+std::string
+ProgramOptions::profileFile(
+) const
+{
+  return m_profileFile;
 }
 
 size_t
@@ -127,6 +296,13 @@ ProgramOptions::numBytes(
   return m_numBytes;
 }
 
+unsigned
+ProgramOptions::numDimensions(
+) const
+{
+  return m_numDimensions;
+}
+
 size_t
 ProgramOptions::randomSeed(
 ) const
@@ -148,6 +324,62 @@ ProgramOptions::numPoints(
   return m_numPoints;
 }
 
+std::string
+ProgramOptions::lengths(
+) const
+{
+  return m_lengths;
+}
+
+double
+ProgramOptions::meanLength(
+) const
+{
+  return m_meanLength;
+}
+
+double
+ProgramOptions::stabDensity(
+) const
+{
+  return m_stabDensity;
+}
+
+std::string
+ProgramOptions::locations(
+) const
+{
+  return m_locations;
+}
+
+size_t
+ProgramOptions::numClusters(
+) const
+{
+  return m_numClusters;
+}
+
+double
+ProgramOptions::zipfExponent(
+) const
+{
+  return m_zipfExponent;
+}
+
+size_t
+ProgramOptions::maxComparators(
+) const
+{
+  return m_maxComparators;
+}
+
+size_t
+ProgramOptions::numSpares(
+) const
+{
+  return m_numSpares;
+}
+
 size_t
 ProgramOptions::maxChunkSize(
 ) const
@@ -155,6 +387,13 @@ ProgramOptions::maxChunkSize(
   return m_maxChunkSize;
 }
 
+unsigned
+ProgramOptions::numThreads(
+) const
+{
+  return m_numThreads;
+}
+
 bool
 ProgramOptions::isReal(
 ) const
@@ -21,6 +21,7 @@
 #define PROGRAMOPTIONS_HPP_
 
 #include <string>
+#include <vector>
 
 #include <boost/program_options.hpp>
 
@@ -37,7 +38,25 @@ public:
   parse(int, char**);
 
   std::string
-  deviceName() const;
+  engine() const;
+
+  std::string
+  mode() const;
+
+  std::string
+  format() const;
+
+  std::string
+  outputFile() const;
+
+  bool
+  indicesOnly() const;
+
+  const std::vector<std::string>&
+  deviceNames() const;
+
+  std::string
+  sharding() const;
 
   std::string
   macrosDir() const;
@@ -45,15 +64,36 @@ public:
   std::string
   fsmName() const;
 
+  std::string
+  cacheDir() const;
+
   std::string
   intervalsFile() const;
 
+  const std::vector<std::string>&
+  pointsFiles() const;
+
+  const std::vector<std::string>&
+  queriesFiles() const;
+
+  std::string
+  saveIntervalsFile() const;
+
+  std::string
+  savePointsFile() const;
+
+  std::string
+  updatesFile() const;
+
   std::string
-  pointsFile() const;
+  profileFile() const;
 
   size_t
   numBytes() const;
 
+  unsigned
+  numDimensions() const;
+
   size_t
   randomSeed() const;
 
@@ -63,9 +103,36 @@ public:
   size_t
   numPoints() const;
 
+  std::string
+  lengths() const;
+
+  double
+  meanLength() const;
+
+  double
+  stabDensity() const;
+
+  std::string
+  locations() const;
+
+  size_t
+  numClusters() const;
+
+  double
+  zipfExponent() const;
+
+  size_t
+  maxComparators() const;
+
+  size_t
+  numSpares() const;
+
   size_t
   maxChunkSize() const;
 
+  unsigned
+  numThreads() const;
+
   bool
   isReal() const;
 
@@ -76,18 +143,40 @@ public:
 
 private:
   po::options_description m_options;
-  std::string m_deviceName;
+  std::string m_engine;
+  std::string m_mode;
+  std::string m_format;
+  std::string m_outputFile;
+  std::vector<std::string> m_deviceNames;
+  std::string m_sharding;
   std::string m_macrosDir;
   std::string m_fsmName;
+  std::string m_cacheDir;
   std::string m_intervalsFile;
-  std::string m_pointsFile;
+  std::vector<std::string> m_pointsFiles;
+  std::vector<std::string> m_queriesFiles;
+  std::string m_saveIntervalsFile;
+  std::string m_savePointsFile;
+  std::string m_updatesFile;
+  std::string m_profileFile;
   size_t m_numBytes;
+  unsigned m_numDimensions;
   size_t m_randomSeed;
   size_t m_numIntervals;
   size_t m_numPoints;
+  std::string m_lengths;
+  double m_meanLength;
+  double m_stabDensity;
+  std::string m_locations;
+  size_t m_numClusters;
+  double m_zipfExponent;
+  size_t m_maxComparators;
+  size_t m_numSpares;
   size_t m_maxChunkSize;
+  unsigned m_numThreads;
   bool m_isReal;
   bool m_isSigned;
+  bool m_indicesOnly;
 }; // class ProgramOptions
 
 #endif // PROGRAMOPTIONS_HPP_
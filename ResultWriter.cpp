@@ -0,0 +1,363 @@
+/**
+ * @file ResultWriter.cpp
+ * @brief Implementation of ResultWriter functions.
+ * @author Ankit Srivastava <asrivast@gatech.edu>
+ *
+ * Copyright 2018 Georgia Institute of Technology
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "ResultWriter.hpp"
+
+#include "Profiler.hpp"
+
+#include <cstring>
+#include <stdexcept>
+
+
+// Pairs of decimal digits of the numbers from 0 to 99, for formatting two digits at a time.
+static const char DigitPairs[] =
+  "00010203040506070809"
+  "10111213141516171819"
+  "20212223242526272829"
+  "30313233343536373839"
+  "40414243444546474849"
+  "50515253545556575859"
+  "60616263646566676869"
+  "70717273747576777879"
+  "80818283848586878889"
+  "90919293949596979899";
+
+/**
+ * @brief  Constructor for opening the output.
+ *
+ * @param fileName     Name of the file to which the results are written, or empty for the standard output.
+ * @param format       Format of the results (text, tsv, binary).
+ * @param indicesOnly  Whether the indices of the intervals are written instead of their limits in the text format.
+ */
+ResultWriter::ResultWriter(
+  const std::string& fileName,
+  const std::string& format,
+  const bool indicesOnly
+) : m_buffer(BufferSize),
+    m_format(format),
+    m_binary(format == "binary"),
+    m_indicesOnly(indicesOnly),
+    m_firstQuery(0),
+    m_fileName(fileName.empty() ? "the standard output" : fileName),
+    m_file(fileName.empty() ? stdout : std::fopen(fileName.c_str(), "wb")),
+    m_used(0),
+    m_written(0)
+{
+  if (m_file == nullptr) {
+    throw std::runtime_error("Couldn't open the file " + fileName + " for writing the results.");
+  }
+}
+
+/**
+ * @brief  Function for getting the format of the results.
+ */
+const std::string&
+ResultWriter::format(
+) const
+{
+  return m_format;
+}
+
+/**
+ * @brief  Function for checking if only the indices of the intervals are written in the text format.
+ */
+bool
+ResultWriter::indicesOnly(
+) const
+{
+  return m_indicesOnly;
+}
+
+/**
+ * @brief  Function for getting the index of the first query of the current batch.
+ */
+size_t
+ResultWriter::firstQuery(
+) const
+{
+  return m_firstQuery;
+}
+
+/**
+ * @brief  Function for ending a batch of queries, which writes out the buffer.
+ *
+ * @param numQueries  Number of queries in the batch.
+ */
+void
+ResultWriter::endBatch(
+  const size_t numQueries
+)
+{
+  m_firstQuery += numQueries;
+  flush();
+}
+
+/**
+ * @brief  Function for writing a pair of indices, or an index and a count, in the format of the results.
+ *
+ * @param first   Index of the query.
+ * @param second  Index of the interval found for the query, or the number of intervals found for it.
+ */
+void
+ResultWriter::writeIndices(
+  const uint64_t first,
+  const uint64_t second
+)
+{
+  if (m_binary) {
+    reserve(2 * sizeof(uint64_t));
+    std::memcpy(&m_buffer[m_used], &first, sizeof(uint64_t));
+    std::memcpy(&m_buffer[m_used + sizeof(uint64_t)], &second, sizeof(uint64_t));
+    m_used += 2 * sizeof(uint64_t);
+  }
+  else {
+    appendUnsigned(first);
+    *this << '\t';
+    appendUnsigned(second);
+    *this << '\n';
+  }
+}
+
+/**
+ * @brief  Functions for appending a character or a string.
+ */
+ResultWriter&
+ResultWriter::operator<<(
+  const char c
+)
+{
+  reserve(1);
+  m_buffer[m_used++] = c;
+  return *this;
+}
+
+ResultWriter&
+ResultWriter::operator<<(
+  const char* const s
+)
+{
+  append(s, std::strlen(s));
+  return *this;
+}
+
+ResultWriter&
+ResultWriter::operator<<(
+  const std::string& s
+)
+{
+  append(s.data(), s.size());
+  return *this;
+}
+
+/**
+ * @brief  Functions for appending a number in the decimal format, as printed by an output stream.
+ */
+ResultWriter&
+ResultWriter::operator<<(
+  const uint32_t value
+)
+{
+  appendUnsigned(value);
+  return *this;
+}
+
+ResultWriter&
+ResultWriter::operator<<(
+  const int32_t value
+)
+{
+  return (*this << static_cast<int64_t>(value));
+}
+
+ResultWriter&
+ResultWriter::operator<<(
+  const uint64_t value
+)
+{
+  appendUnsigned(value);
+  return *this;
+}
+
+ResultWriter&
+ResultWriter::operator<<(
+  const int64_t value
+)
+{
+  if (value < 0) {
+    *this << '-';
+    // Negate in unsigned arithmetic, which also works for the smallest value.
+    appendUnsigned(~static_cast<uint64_t>(value) + 1);
+  }
+  else {
+    appendUnsigned(static_cast<uint64_t>(value));
+  }
+  return *this;
+}
+
+ResultWriter&
+ResultWriter::operator<<(
+  const float value
+)
+{
+  appendReal(value, 6);
+  return *this;
+}
+
+ResultWriter&
+ResultWriter::operator<<(
+  const double value
+)
+{
+  appendReal(value, 6);
+  return *this;
+}
+
+/**
+ * @brief  Function for writing out the buffer.
+ */
+void
+ResultWriter::flush(
+)
+{
+  if ((m_used > 0) && (std::fwrite(m_buffer.data(), 1, m_used, m_file) != m_used)) {
+    throw std::runtime_error("Couldn't write the results to " + m_fileName + ".");
+  }
+  if (std::fflush(m_file) != 0) {
+    throw std::runtime_error("Couldn't write the results to " + m_fileName + ".");
+  }
+  Profiler::addCount("output_bytes", m_used);
+  m_written += m_used;
+  m_used = 0;
+}
+
+/**
+ * @brief  Function for getting the number of bytes written so far, including the buffered bytes.
+ */
+size_t
+ResultWriter::bytes(
+) const
+{
+  return m_written + m_used;
+}
+
+/**
+ * @brief  Function for making room for the given number of bytes in the buffer.
+ *
+ * @param count  Number of bytes, which must not be more than the size of the buffer.
+ */
+void
+ResultWriter::reserve(
+  const size_t count
+)
+{
+  if (m_used + count > m_buffer.size()) {
+    flush();
+  }
+}
+
+/**
+ * @brief  Function for appending the given bytes.
+ *
+ * @param data   Pointer to the bytes.
+ * @param count  Number of bytes.
+ */
+void
+ResultWriter::append(
+  const char* const data,
+  const size_t count
+)
+{
+  if (count > m_buffer.size()) {
+    flush();
+    if (std::fwrite(data, 1, count, m_file) != count) {
+      throw std::runtime_error("Couldn't write the results to " + m_fileName + ".");
+    }
+    Profiler::addCount("output_bytes", count);
+    m_written += count;
+    return;
+  }
+  reserve(count);
+  std::memcpy(&m_buffer[m_used], data, count);
+  m_used += count;
+}
+
+/**
+ * @brief  Function for appending the decimal digits of an unsigned number, two digits at a time.
+ *
+ * @param value  Number to be appended.
+ */
+void
+ResultWriter::appendUnsigned(
+  uint64_t value
+)
+{
+  // The largest 64-bit number has 20 digits.
+  char digits[20];
+  char* first = digits + sizeof(digits);
+  while (value >= 100) {
+    const unsigned pair = static_cast<unsigned>(value % 100) * 2;
+    value /= 100;
+    *--first = DigitPairs[pair + 1];
+    *--first = DigitPairs[pair];
+  }
+  if (value >= 10) {
+    const unsigned pair = static_cast<unsigned>(value) * 2;
+    *--first = DigitPairs[pair + 1];
+    *--first = DigitPairs[pair];
+  }
+  else {
+    *--first = static_cast<char>('0' + value);
+  }
+  append(first, (digits + sizeof(digits)) - first);
+}
+
+/**
+ * @brief  Function for appending a real number in the general format, with the given precision.
+ *
+ * @param value      Number to be appended.
+ * @param precision  Number of significant digits.
+ */
+void
+ResultWriter::appendReal(
+  const double value,
+  const int precision
+)
+{
+  // Enough for the sign, the significant digits, the point, and the exponent.
+  const size_t maxLength = 32;
+  reserve(maxLength);
+  int length = std::snprintf(&m_buffer[m_used], maxLength, "%.*g", precision, value);
+  m_used += static_cast<size_t>(length);
+}
+
+/**
+ * @brief  Destructor, which writes out the buffer and closes the file.
+ */
+ResultWriter::~ResultWriter(
+)
+{
+  try {
+    flush();
+  }
+  catch (...) {
+  }
+  if (m_file != stdout) {
+    std::fclose(m_file);
+  }
+}
@@ -0,0 +1,128 @@
+/**
+ * @file ResultWriter.hpp
+ * @brief Declaration of ResultWriter functions.
+ * @author Ankit Srivastava <asrivast@gatech.edu>
+ *
+ * Copyright 2018 Georgia Institute of Technology
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef RESULTWRITER_HPP_
+#define RESULTWRITER_HPP_
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+
+/**
+ * @brief  Class for writing the results of a run to the standard output or a file, through a large buffer.
+ *
+ * Text is appended to the buffer without flushing after every line, and numbers are formatted
+ * directly into the buffer instead of through a stream. The buffer is written out when it is full,
+ * on flush(), and on destruction.
+ *
+ * Besides the text tables, which are written by the caller, the results can be written as pairs
+ * of indices, either one pair per line separated by a tab (tsv), or as two 8-byte numbers in the
+ * byte order of the host (binary). The indices of the queries continue across the batches.
+ */
+class ResultWriter {
+public:
+  ResultWriter(const std::string&, const std::string&, const bool);
+
+  const std::string&
+  format() const;
+
+  bool
+  indicesOnly() const;
+
+  size_t
+  firstQuery() const;
+
+  void
+  endBatch(const size_t);
+
+  void
+  writeIndices(const uint64_t, const uint64_t);
+
+  ResultWriter&
+  operator<<(const char);
+
+  ResultWriter&
+  operator<<(const char* const);
+
+  ResultWriter&
+  operator<<(const std::string&);
+
+  ResultWriter&
+  operator<<(const uint32_t);
+
+  ResultWriter&
+  operator<<(const int32_t);
+
+  ResultWriter&
+  operator<<(const uint64_t);
+
+  ResultWriter&
+  operator<<(const int64_t);
+
+  ResultWriter&
+  operator<<(const float);
+
+  ResultWriter&
+  operator<<(const double);
+
+  void
+  flush();
+
+  size_t
+  bytes() const;
+
+  ~ResultWriter();
+
+private:
+  ResultWriter(const ResultWriter&);
+
+  ResultWriter&
+  operator=(const ResultWriter&);
+
+  void
+  reserve(const size_t);
+
+  void
+  append(const char* const, const size_t);
+
+  void
+  appendUnsigned(uint64_t);
+
+  void
+  appendReal(const double, const int);
+
+private:
+  // Size of the buffer, which is written out when it is full.
+  static const size_t BufferSize = 1 << 22;
+
+private:
+  std::vector<char> m_buffer;
+  std::string m_format;
+  bool m_binary;
+  bool m_indicesOnly;
+  size_t m_firstQuery;
+  std::string m_fileName;
+  std::FILE* m_file;
+  size_t m_used;
+  size_t m_written;
+}; // class ResultWriter
+
+#endif // RESULTWRITER_HPP_
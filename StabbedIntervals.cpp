@@ -0,0 +1,273 @@
+/**
+ * @file StabbedIntervals.cpp
+ * @brief Implementation of StabbedIntervals functions.
+ * @author Ankit Srivastava <asrivast@gatech.edu>
+ *
+ * Copyright 2018 Georgia Institute of Technology
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "StabbedIntervals.hpp"
+
+#include <utility>
+
+
+/**
+ * @brief  Default constructor for a container without any points.
+ */
+StabbedIntervals::StabbedIntervals(
+) : m_offsets(1, 0),
+    m_indices()
+{
+}
+
+/**
+ * @brief  Constructor for counting the stabs of the given number of points.
+ *
+ * @param numPoints  Number of points.
+ */
+StabbedIntervals::StabbedIntervals(
+  const size_t numPoints
+) : m_offsets(numPoints + 1, 0),
+    m_indices()
+{
+}
+
+/**
+ * @brief  Constructor for a container built elsewhere.
+ *
+ * @param offsets  Offsets of the first stab of every point, followed by the total number of stabs.
+ * @param indices  Indices of the stabbed intervals, for all the points one after the other.
+ */
+StabbedIntervals::StabbedIntervals(
+  std::vector<size_t>&& offsets,
+  std::vector<size_t>&& indices
+) : m_offsets(std::move(offsets)),
+    m_indices(std::move(indices))
+{
+}
+
+/**
+ * @brief  Constructor for concatenating the containers for consecutive ranges of points.
+ *
+ * @param parts  Containers for the ranges of points, in the order of the points.
+ */
+StabbedIntervals::StabbedIntervals(
+  const std::vector<StabbedIntervals>& parts
+) : m_offsets(1, 0),
+    m_indices()
+{
+  reserve(parts);
+  for (const StabbedIntervals& part : parts) {
+    append(part);
+  }
+}
+
+/**
+ * @brief  Constructor for concatenating the containers for consecutive ranges of points,
+ *         freeing every container as soon as it has been appended.
+ *
+ * @param parts  Containers for the ranges of points, in the order of the points. All of them are left empty.
+ *
+ * The storage of a single container is taken over instead of being copied.
+ */
+StabbedIntervals::StabbedIntervals(
+  std::vector<StabbedIntervals>&& parts
+) : m_offsets(1, 0),
+    m_indices()
+{
+  if (parts.size() == 1) {
+    *this = std::move(parts[0]);
+    parts[0] = StabbedIntervals();
+    return;
+  }
+  reserve(parts);
+  for (StabbedIntervals& part : parts) {
+    append(part);
+    part = StabbedIntervals();
+  }
+}
+
+/**
+ * @brief  Function for counting stabs of a point, before the storage is allocated.
+ *
+ * @param point  Index of the point.
+ * @param count  Number of the stabs to be counted.
+ */
+void
+StabbedIntervals::count(
+  const size_t point,
+  const size_t count
+)
+{
+  m_offsets[point + 1] += count;
+}
+
+/**
+ * @brief  Function for allocating the storage for all the counted stabs.
+ *
+ * After allocation, m_offsets[p + 1] is used as the position of the next stab of point p.
+ * Once all the counted stabs have been added, it ends up at the end of the stabs of point p.
+ */
+void
+StabbedIntervals::allocate(
+)
+{
+  size_t total = 0;
+  for (size_t p = 1; p < m_offsets.size(); ++p) {
+    size_t count = m_offsets[p];
+    m_offsets[p] = total;
+    total += count;
+  }
+  m_indices.resize(total);
+}
+
+/**
+ * @brief  Function for adding a stab of a point, after the storage is allocated.
+ *
+ * @param point     Index of the point.
+ * @param interval  Index of the stabbed interval.
+ */
+void
+StabbedIntervals::add(
+  const size_t point,
+  const size_t interval
+)
+{
+  m_indices[m_offsets[point + 1]++] = interval;
+}
+
+/**
+ * @brief  Function for getting the number of points in the container.
+ *
+ * @return  The number of points.
+ */
+size_t
+StabbedIntervals::numPoints(
+) const
+{
+  return m_offsets.size() - 1;
+}
+
+/**
+ * @brief  Function for getting the total number of stabs in the container.
+ *
+ * @return  The number of stabs of all the points.
+ */
+size_t
+StabbedIntervals::size(
+) const
+{
+  return m_indices.size();
+}
+
+/**
+ * @brief  Function for getting the number of stabs of a point.
+ *
+ * @param point  Index of the point.
+ *
+ * @return  The number of intervals stabbed by the point.
+ */
+size_t
+StabbedIntervals::size(
+  const size_t point
+) const
+{
+  return m_offsets[point + 1] - m_offsets[point];
+}
+
+/**
+ * @brief  Function for checking if none of the points stabbed any intervals.
+ *
+ * @return  true if there are no stabs in the container.
+ */
+bool
+StabbedIntervals::empty(
+) const
+{
+  return m_indices.empty();
+}
+
+/**
+ * @brief  Function for accessing the first stab of a point.
+ *
+ * @param point  Index of the point.
+ *
+ * @return  Pointer to the index of the first interval stabbed by the point.
+ */
+const size_t*
+StabbedIntervals::begin(
+  const size_t point
+) const
+{
+  return m_indices.data() + m_offsets[point];
+}
+
+/**
+ * @brief  Function for accessing the end of the stabs of a point.
+ *
+ * @param point  Index of the point.
+ *
+ * @return  Pointer one past the index of the last interval stabbed by the point.
+ */
+const size_t*
+StabbedIntervals::end(
+  const size_t point
+) const
+{
+  return m_indices.data() + m_offsets[point + 1];
+}
+
+/**
+ * @brief  Function for reserving the storage for concatenating the given containers.
+ *
+ * @param parts  Containers to be concatenated.
+ */
+void
+StabbedIntervals::reserve(
+  const std::vector<StabbedIntervals>& parts
+)
+{
+  size_t numPoints = 0, numStabs = 0;
+  for (const StabbedIntervals& part : parts) {
+    numPoints += part.numPoints();
+    numStabs += part.size();
+  }
+  m_offsets.reserve(numPoints + 1);
+  m_indices.reserve(numStabs);
+}
+
+/**
+ * @brief  Function for appending the stabs of the points in the given container.
+ *
+ * @param part  Container for the points following the points in this container.
+ */
+void
+StabbedIntervals::append(
+  const StabbedIntervals& part
+)
+{
+  size_t shift = m_indices.size();
+  for (size_t p = 1; p < part.m_offsets.size(); ++p) {
+    m_offsets.push_back(part.m_offsets[p] + shift);
+  }
+  m_indices.insert(m_indices.end(), part.m_indices.begin(), part.m_indices.end());
+}
+
+/**
+ * @brief  Default destructor.
+ */
+StabbedIntervals::~StabbedIntervals(
+)
+{
+}
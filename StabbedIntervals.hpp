@@ -0,0 +1,98 @@
+/**
+ * @file StabbedIntervals.hpp
+ * @brief Declaration of StabbedIntervals functions.
+ * @author Ankit Srivastava <asrivast@gatech.edu>
+ *
+ * Copyright 2018 Georgia Institute of Technology
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef STABBEDINTERVALS_HPP_
+#define STABBEDINTERVALS_HPP_
+
+#include <cstddef>
+#include <vector>
+
+
+/**
+ * @brief  Container for the indices of the intervals stabbed by every point,
+ *         stored in the compressed sparse row format.
+ *
+ * The container can be built either from ready offsets and indices, or in two passes:
+ * first the stabs of every point are counted, then storage is allocated and the stabs are added.
+ * Containers for consecutive ranges of points can also be concatenated into one.
+ */
+class StabbedIntervals {
+public:
+  StabbedIntervals();
+
+  StabbedIntervals(const size_t);
+
+  StabbedIntervals(std::vector<size_t>&&, std::vector<size_t>&&);
+
+  StabbedIntervals(const std::vector<StabbedIntervals>&);
+
+  StabbedIntervals(std::vector<StabbedIntervals>&&);
+
+  StabbedIntervals(const StabbedIntervals&) = default;
+
+  StabbedIntervals(StabbedIntervals&&) = default;
+
+  StabbedIntervals&
+  operator=(const StabbedIntervals&) = default;
+
+  StabbedIntervals&
+  operator=(StabbedIntervals&&) = default;
+
+  void
+  count(const size_t, const size_t);
+
+  void
+  allocate();
+
+  void
+  add(const size_t, const size_t);
+
+  size_t
+  numPoints() const;
+
+  size_t
+  size() const;
+
+  size_t
+  size(const size_t) const;
+
+  bool
+  empty() const;
+
+  const size_t*
+  begin(const size_t) const;
+
+  const size_t*
+  end(const size_t) const;
+
+  ~StabbedIntervals();
+
+private:
+  void
+  reserve(const std::vector<StabbedIntervals>&);
+
+  void
+  append(const StabbedIntervals&);
+
+private:
+  std::vector<size_t> m_offsets;
+  std::vector<size_t> m_indices;
+}; // class StabbedIntervals
+
+#endif // STABBEDINTERVALS_HPP_
@@ -0,0 +1,1335 @@
+/**
+ * @file StabbingSession.cpp
+ * @brief Implementation of StabbingSession functions.
+ * @author Ankit Srivastava <asrivast@gatech.edu>
+ *
+ * Copyright 2018 Georgia Institute of Technology
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "StabbingSession.hpp"
+
+#include "BoundedQueue.hpp"
+#include "ByteOrder.hpp"
+#include "LimitOrder.hpp"
+#include "Parallel.hpp"
+#include "Profiler.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <future>
+#include <iostream>
+#include <stdexcept>
+
+
+template <typename LimitType>
+const size_t StabbingSession<LimitType>::None;
+
+/**
+ * @brief  Function for sorting the reports of the automaton by their offsets.
+ *
+ * @param reports  Reports, which are usually already sorted.
+ */
+static
+void
+sortReports(
+  std::vector<std::pair<size_t, ap::ElementRef> >& reports
+)
+{
+  auto compareOffsets = [](const std::pair<size_t, ap::ElementRef>& a, const std::pair<size_t, ap::ElementRef>& b)
+                        { return a.first < b.first; };
+  if (!std::is_sorted(reports.begin(), reports.end(), compareOffsets)) {
+    std::stable_sort(reports.begin(), reports.end(), compareOffsets);
+  }
+}
+
+/**
+ * @brief  Constructor for preparing the given engine for stabbing the given intervals.
+ *
+ * @tparam LimitType       Datatype of the interval limits.
+ * @param  intervals       Intervals to be stabbed.
+ * @param  engine          Name of the engine to be used for checking intervals.
+ * @param  deviceNames     Names of the AP devices to be used for checking intervals.
+ * @param  sharding        How the work is split between the devices (auto, intervals, points).
+ * @param  macrosDir       Directory which contains all the comparator macros.
+ * @param  fsmName         Name of the FSM file to be written.
+ * @param  cacheDir        Directory in which compiled automata are cached. Empty if no caching is needed.
+ * @param  maxComparators  Maximum number of comparators in one automaton. 0 if the capacity of the board should be used.
+ * @param  numSpares       Number of spare comparators on which inserted intervals are programmed.
+ * @param  maxChunkSize    Maximum size of the flow that can be streamed to the AP.
+ * @param  numThreads      Number of threads to be used on the host. 0 means one thread per hardware thread.
+ *
+ * For the AP engine, a device named "simulator" is simulated on the CPU. If no devices are given,
+ * one simulated device is used for every host thread. If a device is assigned only one automaton,
+ * it is loaded on the device and stays loaded until the session is destroyed. Otherwise, the automata
+ * are kept on the host and loaded on the device one after the other for every batch of points.
+ *
+ * If all the intervals fit in one automaton, streaming a range of the points to every device is the fastest,
+ * since all the automata stay loaded and every device streams only a fraction of the points. Otherwise,
+ * sharding the automata requires the same amount of streaming from every device but fewer loads,
+ * since every automaton is loaded on only one device. Therefore, the automata are sharded by default only if
+ * the intervals need more than one automaton.
+ *
+ * If spare comparators are requested, the automata are also kept on the host, so that they can be relabeled
+ * and loaded again when intervals are inserted or erased.
+ */
+template <typename LimitType>
+StabbingSession<LimitType>::StabbingSession(
+  const Intervals<LimitType>& intervals,
+  const std::string& engine,
+  const std::vector<std::string>& deviceNames,
+  const std::string& sharding,
+  const std::string& macrosDir,
+  const std::string& fsmName,
+  const std::string& cacheDir,
+  const size_t maxComparators,
+  const size_t numSpares,
+  const size_t maxChunkSize,
+  const unsigned numThreads
+) : m_intervals(intervals),
+    m_engine(engine),
+    m_macrosDir(macrosDir),
+    m_numSpares(numSpares),
+    m_flowChunkSize((maxChunkSize / B) * B),
+    m_numThreads(getNumThreads(numThreads)),
+    m_splitPoints(true),
+    m_distinct(),
+    m_duplicateOffsets(),
+    m_duplicateIndices(),
+    m_programmed(&intervals),
+    m_elements(),
+    m_perAutomaton(0),
+    m_numAutomata(0),
+    m_automata(),
+    m_simulators(),
+    m_boards(),
+    m_tree(),
+    m_lower(),
+    m_upper(),
+    m_upperRanks(),
+    m_updated(false),
+    m_inserted(),
+    m_erased(),
+    m_slotHeads(),
+    m_nextDuplicate(),
+    m_slots(),
+    m_freeSlots(),
+    m_changedSlots(),
+    m_insertedRuns(),
+    m_erasedRuns()
+{
+  if (m_engine == "ap") {
+    if ((sharding != "auto") && (sharding != "intervals") && (sharding != "points")) {
+      throw std::runtime_error("Unsupported sharding.");
+    }
+    if (deviceNames.empty()) {
+      std::cerr << "WARNING: AP device name was not provided. Simulating the automaton on the CPU." << std::endl;
+    }
+    // Program identical intervals only once.
+    m_distinct = intervals.deduplicate(m_duplicateOffsets, m_duplicateIndices);
+    if (m_distinct.count() < intervals.count()) {
+      std::cerr << "Programming " << m_distinct.count() << " distinct intervals out of " << intervals.count() << "." << std::endl;
+      m_programmed = &m_distinct;
+    }
+    else {
+      m_distinct = Intervals<LimitType>();
+      m_duplicateOffsets.clear();
+      m_duplicateIndices.clear();
+    }
+    const Intervals<LimitType>& programmed = *m_programmed;
+
+    size_t numBoards = deviceNames.empty() ? m_numThreads : deviceNames.size();
+    // Decide how to split the work between the devices.
+    size_t perAutomaton = Intervals<LimitType>::capacity(maxComparators);
+    size_t numAutomata = (programmed.count() + numSpares + perAutomaton - 1) / perAutomaton;
+    m_splitPoints = (numBoards == 1) || (sharding == "points") || ((sharding == "auto") && (numAutomata <= 1));
+    if (!m_splitPoints && (numAutomata < numBoards)) {
+      // Use smaller automata so that every device gets one.
+      perAutomaton = std::max((programmed.count() + numSpares + numBoards - 1) / numBoards, static_cast<size_t>(1));
+    }
+
+    // Get the automata for the intervals.
+    std::pair<std::vector<ap::Automaton>, ElementTable> automata(programmed.program(macrosDir, fsmName, cacheDir, perAutomaton, numSpares, m_numThreads));
+    m_elements = std::move(automata.second);
+    m_perAutomaton = perAutomaton;
+    m_numAutomata = automata.first.size();
+
+    // Assign the automata to the devices.
+    m_boards.resize(numBoards);
+    bool simulated = false, reloaded = false, loaded = false;
+    for (size_t d = 0; d < numBoards; ++d) {
+      Board& board = m_boards[d];
+      size_t first = m_splitPoints ? 0 : (m_numAutomata * d) / numBoards;
+      size_t last = m_splitPoints ? m_numAutomata : (m_numAutomata * (d + 1)) / numBoards;
+      for (size_t n = first; n < last; ++n) {
+        board.automata.push_back(n);
+      }
+      board.loaded = false;
+      if (deviceNames.empty() || (deviceNames[d] == "simulator")) {
+        simulated = true;
+        continue;
+      }
+      // Open the device and load the automaton on it, if there is only one.
+      board.device.reset(new ap::Device(deviceNames[d]));
+      if (board.automata.size() == 1) {
+        ProfiledPhase load("load");
+        board.device->load(automata.first[board.automata.front()]);
+        board.loaded = true;
+        loaded = true;
+      }
+      else {
+        reloaded = true;
+      }
+    }
+    if (reloaded || (loaded && (numSpares > 0))) {
+      m_automata = std::move(automata.first);
+    }
+    if (simulated) {
+      // Program the comparators on the simulators in the order of the intervals.
+      // All the comparators are added if there are spares, so that the intervals can be programmed on them later.
+      m_simulators.resize(m_numAutomata);
+      size_t numSlots = (numSpares > 0) ? (m_numAutomata * m_elements.size()) : programmed.count();
+      std::array<unsigned char, B> x, y;
+      for (size_t i = 0; i < numSlots; ++i) {
+        if (i < programmed.count()) {
+          reverse_memcpy(&x[0], &programmed.get(i).first, B);
+          reverse_memcpy(&y[0], &programmed.get(i).second, B);
+          m_simulators[i / m_perAutomaton].program(m_elements.get(i % m_perAutomaton), &x[0], &y[0]);
+        }
+        else {
+          m_simulators[i / m_perAutomaton].program(m_elements.get(i % m_perAutomaton));
+        }
+      }
+    }
+  }
+  else if (m_engine == "tree") {
+    m_tree.reset(new IntervalTree<LimitType>(intervals.data(), intervals.count()));
+  }
+  else if (m_engine == "sweep") {
+    sortLimits();
+  }
+  else {
+    throw std::runtime_error("Unsupported engine.");
+  }
+}
+
+/**
+ * @brief  Function for sorting the lower and the upper limits of the intervals while remembering their indices.
+ *
+ * @tparam LimitType  Datatype of the interval limits.
+ *
+ * The position of the upper limit of every interval in the sorted upper limits is also stored.
+ */
+template <typename LimitType>
+void
+StabbingSession<LimitType>::sortLimits(
+)
+{
+  m_lower.resize(m_intervals.count());
+  m_upper.resize(m_intervals.count());
+  for (size_t i = 0; i < m_intervals.count(); ++i) {
+    m_lower[i] = std::make_pair(m_intervals.get(i).first, i);
+    m_upper[i] = std::make_pair(m_intervals.get(i).second, i);
+  }
+  auto compareLimits = [](const LimitIndex& a, const LimitIndex& b) { return limitLess(a.first, b.first); };
+  std::sort(m_lower.begin(), m_lower.end(), compareLimits);
+  std::sort(m_upper.begin(), m_upper.end(), compareLimits);
+  m_upperRanks.resize(m_intervals.count());
+  for (size_t r = 0; r < m_upper.size(); ++r) {
+    m_upperRanks[m_upper[r].second] = r;
+  }
+}
+
+/**
+ * @brief  Function for preparing the session for inserting and erasing intervals.
+ *
+ * @tparam LimitType  Datatype of the interval limits.
+ *
+ * For the AP engine, the intervals programmed on every comparator are linked in a list, so that
+ * they can be changed one at a time. The comparators which don't have any intervals are spare,
+ * if spare comparators were requested.
+ */
+template <typename LimitType>
+void
+StabbingSession<LimitType>::prepareUpdates(
+)
+{
+  m_updated = true;
+  m_erased.assign(m_intervals.count(), false);
+  if (m_engine != "ap") {
+    return;
+  }
+  // The c-th comparator of the n-th automaton is the (n * m_perAutomaton + c)-th slot.
+  size_t numSlots = m_numAutomata * m_elements.size();
+  m_slotHeads.assign(numSlots, None);
+  m_nextDuplicate.assign(m_intervals.count(), None);
+  m_slots.assign(m_intervals.count(), None);
+  const bool duplicates = !m_duplicateOffsets.empty();
+  for (size_t slot = 0; slot < m_programmed->count(); ++slot) {
+    size_t first = duplicates ? m_duplicateOffsets[slot] : slot;
+    size_t last = duplicates ? m_duplicateOffsets[slot + 1] : (slot + 1);
+    // Link the intervals in reverse, so that the list is in the order of the intervals.
+    for (size_t d = last; d > first; --d) {
+      size_t interval = duplicates ? m_duplicateIndices[d - 1] : (d - 1);
+      m_nextDuplicate[interval] = m_slotHeads[slot];
+      m_slotHeads[slot] = interval;
+      m_slots[interval] = slot;
+    }
+  }
+  if (m_numSpares > 0) {
+    // Spare comparators are used in order.
+    for (size_t slot = numSlots; slot > m_programmed->count(); --slot) {
+      m_freeSlots.push_back(slot - 1);
+    }
+  }
+}
+
+/**
+ * @brief  Function for inserting an interval.
+ *
+ * @tparam LimitType  Datatype of the interval limits.
+ * @param  interval   Interval to be inserted.
+ *
+ * @return  Index of the inserted interval, which is after all the existing intervals.
+ *
+ * The AP engine programs the interval on a spare comparator when the intervals are stabbed next.
+ * The interval is also added to an index of the inserted intervals, in amortized logarithmic time,
+ * which is used for stabbing by the other engines and for overlap queries by all the engines.
+ */
+template <typename LimitType>
+size_t
+StabbingSession<LimitType>::insert(
+  const std::pair<LimitType, LimitType>& interval
+)
+{
+  if (limitLess(interval.second, interval.first)) {
+    throw std::runtime_error("The lower limit of the inserted interval is after its upper limit.");
+  }
+  if (!m_updated) {
+    prepareUpdates();
+  }
+  size_t index = size();
+  if (m_engine == "ap") {
+    if (std::is_floating_point<LimitType>::value && std::signbit(interval.first) && !std::signbit(interval.second)) {
+      throw std::runtime_error("An interval which crosses zero should be inserted as two intervals.");
+    }
+    if (m_freeSlots.empty()) {
+      throw std::runtime_error("No spare comparators are left for inserting the interval.");
+    }
+    size_t slot = m_freeSlots.back();
+    m_freeSlots.pop_back();
+    m_slotHeads[slot] = index;
+    m_nextDuplicate.push_back(None);
+    m_slots.push_back(slot);
+    m_changedSlots.push_back(slot);
+  }
+  m_insertedRuns.insert(interval, index);
+  m_inserted.push_back(interval);
+  m_erased.push_back(false);
+  return index;
+}
+
+/**
+ * @brief  Function for erasing an interval.
+ *
+ * @tparam LimitType  Datatype of the interval limits.
+ * @param  index      Index of the interval to be erased.
+ *
+ * Indices of the other intervals don't change. The AP engine disables the comparator of the interval
+ * when the intervals are stabbed next, unless identical intervals are programmed on it, and reuses it as a spare.
+ * Without spare comparators, the comparator isn't relabeled and its reports are ignored instead.
+ * The interval is also added to an index of the erased intervals, which the other engines use for
+ * filtering the stabbed intervals, and all the engines use for adjusting the counts.
+ */
+template <typename LimitType>
+void
+StabbingSession<LimitType>::erase(
+  const size_t index
+)
+{
+  if (index >= size()) {
+    throw std::runtime_error("The erased interval doesn't exist.");
+  }
+  if (!m_updated) {
+    prepareUpdates();
+  }
+  if (m_erased[index]) {
+    throw std::runtime_error("The interval has already been erased.");
+  }
+  m_erased[index] = true;
+  if (m_engine == "ap") {
+    size_t slot = m_slots[index];
+    size_t* link = &m_slotHeads[slot];
+    while (*link != index) {
+      link = &m_nextDuplicate[*link];
+    }
+    *link = m_nextDuplicate[index];
+    if ((m_slotHeads[slot] == None) && (m_numSpares > 0)) {
+      m_freeSlots.push_back(slot);
+      m_changedSlots.push_back(slot);
+    }
+  }
+  m_erasedRuns.insert(get(index), index);
+}
+
+/**
+ * @brief  Function for getting an interval, including the inserted ones.
+ *
+ * @tparam LimitType  Datatype of the interval limits.
+ * @param  index      Index of the interval.
+ */
+template <typename LimitType>
+const std::pair<LimitType, LimitType>&
+StabbingSession<LimitType>::get(
+  const size_t index
+) const
+{
+  return (index < m_intervals.count()) ? m_intervals.get(index) : m_inserted[index - m_intervals.count()];
+}
+
+/**
+ * @brief  Function for getting the number of intervals, including the inserted and the erased ones.
+ *
+ * @tparam LimitType  Datatype of the interval limits.
+ */
+template <typename LimitType>
+size_t
+StabbingSession<LimitType>::size(
+) const
+{
+  return m_intervals.count() + m_inserted.size();
+}
+
+/**
+ * @brief  Function for relabeling the comparators changed by the updates since the last batch of points.
+ *
+ * @tparam LimitType  Datatype of the interval limits.
+ *
+ * The changes are grouped by automaton, so that every automaton is relabeled with one symbol change.
+ * The automata which are loaded on the devices are loaded again after relabeling.
+ */
+template <typename LimitType>
+void
+StabbingSession<LimitType>::applyUpdates(
+)
+{
+  if (m_changedSlots.empty()) {
+    return;
+  }
+  std::sort(m_changedSlots.begin(), m_changedSlots.end());
+  m_changedSlots.erase(std::unique(m_changedSlots.begin(), m_changedSlots.end()), m_changedSlots.end());
+  std::vector<std::vector<std::pair<size_t, const std::pair<LimitType, LimitType>*> > > changes(m_numAutomata);
+  for (size_t slot : m_changedSlots) {
+    const std::pair<LimitType, LimitType>* interval = (m_slotHeads[slot] != None) ? &get(m_slotHeads[slot]) : nullptr;
+    changes[slot / m_perAutomaton].push_back(std::make_pair(slot % m_perAutomaton, interval));
+  }
+  m_changedSlots.clear();
+
+  std::array<unsigned char, B> x, y;
+  for (size_t n = 0; n < m_numAutomata; ++n) {
+    if (changes[n].empty()) {
+      continue;
+    }
+    if (!m_automata.empty()) {
+      Intervals<LimitType>::relabel(m_macrosDir, m_elements, changes[n], m_automata[n]);
+    }
+    if (!m_simulators.empty()) {
+      for (const std::pair<size_t, const std::pair<LimitType, LimitType>*>& change : changes[n]) {
+        if (change.second == nullptr) {
+          m_simulators[n].disable(change.first);
+        }
+        else {
+          reverse_memcpy(&x[0], &change.second->first, B);
+          reverse_memcpy(&y[0], &change.second->second, B);
+          m_simulators[n].reprogram(change.first, &x[0], &y[0]);
+        }
+      }
+    }
+  }
+  for (Board& board : m_boards) {
+    if (board.loaded && !changes[board.automata.front()].empty()) {
+      ProfiledPhase load("load");
+      board.device->unload();
+      board.device->load(m_automata[board.automata.front()]);
+    }
+  }
+}
+
+/**
+ * @brief  Function for getting the number of comparators of an automaton which may have intervals.
+ *
+ * @tparam LimitType  Datatype of the interval limits.
+ * @param  n          Index of the automaton.
+ */
+template <typename LimitType>
+size_t
+StabbingSession<LimitType>::numComparators(
+  const size_t n
+) const
+{
+  if (m_updated) {
+    return m_elements.size();
+  }
+  else {
+    return std::min(m_programmed->count() - (n * m_perAutomaton), m_perAutomaton);
+  }
+}
+
+/**
+ * @brief  Function for getting the number of intervals stabbed when a comparator reports.
+ *
+ * @tparam LimitType  Datatype of the interval limits.
+ * @param  slot       Slot of the comparator.
+ */
+template <typename LimitType>
+size_t
+StabbingSession<LimitType>::numStabbed(
+  const size_t slot
+) const
+{
+  if (m_updated) {
+    size_t stabbed = 0;
+    for (size_t i = m_slotHeads[slot]; i != None; i = m_nextDuplicate[i]) {
+      ++stabbed;
+    }
+    return stabbed;
+  }
+  else if (!m_duplicateOffsets.empty()) {
+    return m_duplicateOffsets[slot + 1] - m_duplicateOffsets[slot];
+  }
+  else {
+    return 1;
+  }
+}
+
+/**
+ * @brief  Function for adding the intervals stabbed when a comparator reports.
+ *
+ * @tparam LimitType         Datatype of the interval limits.
+ * @param  stabbedIntervals  Container to which the stabbed intervals are added.
+ * @param  point             Index of the point in the container.
+ * @param  slot              Slot of the comparator.
+ */
+template <typename LimitType>
+void
+StabbingSession<LimitType>::addStabbed(
+  StabbedIntervals& stabbedIntervals,
+  const size_t point,
+  const size_t slot
+) const
+{
+  if (m_updated) {
+    for (size_t i = m_slotHeads[slot]; i != None; i = m_nextDuplicate[i]) {
+      stabbedIntervals.add(point, i);
+    }
+  }
+  else if (!m_duplicateOffsets.empty()) {
+    for (size_t d = m_duplicateOffsets[slot]; d < m_duplicateOffsets[slot + 1]; ++d) {
+      stabbedIntervals.add(point, m_duplicateIndices[d]);
+    }
+  }
+  else {
+    stabbedIntervals.add(point, slot);
+  }
+}
+
+/**
+ * @brief  Function for checking which intervals are stabbed by the given points.
+ *
+ * @tparam LimitType  Datatype of the interval limits.
+ * @param  points     Points to be checked.
+ *
+ * @return  Indices of the intervals which are stabbed by every point.
+ */
+template <typename LimitType>
+StabbedIntervals
+StabbingSession<LimitType>::query(
+  const Points<LimitType>& points
+)
+{
+  if (m_engine == "ap") {
+    return queryAutomaton(points, nullptr);
+  }
+  StabbedIntervals stabbedIntervals((m_engine == "tree") ? queryTree(points) : querySweep(points));
+  if (m_updated) {
+    return updateStabs(points, std::move(stabbedIntervals));
+  }
+  return stabbedIntervals;
+}
+
+/**
+ * @brief  Function for counting the intervals which are stabbed by the given points.
+ *
+ * @tparam LimitType  Datatype of the interval limits.
+ * @param  points     Points to be checked.
+ *
+ * @return  Number of intervals stabbed by every point.
+ *
+ * The stabbed intervals are never stored. The AP engine adds up the reports for every point,
+ * and the other engines count the limits on either side of every point in the sorted limits.
+ */
+template <typename LimitType>
+std::vector<size_t>
+StabbingSession<LimitType>::count(
+  const Points<LimitType>& points
+)
+{
+  std::vector<size_t> counts(points.count());
+  if (m_engine == "ap") {
+    queryAutomaton(points, counts.data());
+  }
+  else {
+    countLimits(points, counts.data());
+  }
+  return counts;
+}
+
+/**
+ * @brief  Function for checking which of the given points stab any interval.
+ *
+ * @tparam LimitType  Datatype of the interval limits.
+ * @param  points     Points to be checked.
+ *
+ * @return  A bit for every point, which is set if the point stabs at least one interval.
+ */
+template <typename LimitType>
+std::vector<bool>
+StabbingSession<LimitType>::any(
+  const Points<LimitType>& points
+)
+{
+  std::vector<size_t> counts(count(points));
+  std::vector<bool> stabbing(counts.size());
+  for (size_t p = 0; p < counts.size(); ++p) {
+    stabbing[p] = (counts[p] > 0);
+  }
+  return stabbing;
+}
+
+/**
+ * @brief  Function for getting the lower limits of the given intervals as points.
+ *
+ * @tparam LimitType  Datatype of the interval limits.
+ * @param  queries    Intervals whose lower limits are needed.
+ */
+template <typename LimitType>
+static
+Points<LimitType>
+lowerLimits(
+  const Intervals<LimitType>& queries
+)
+{
+  std::vector<LimitType> lower(queries.count());
+  for (size_t q = 0; q < queries.count(); ++q) {
+    lower[q] = queries.get(q).first;
+  }
+  return Points<LimitType>(std::move(lower));
+}
+
+/**
+ * @brief  Function for checking which intervals overlap the given query intervals.
+ *
+ * @tparam LimitType  Datatype of the interval limits.
+ * @param  queries    Query intervals to be checked.
+ *
+ * @return  Indices of the intervals which overlap every query interval.
+ *
+ * An interval overlaps the query [a, b] if it is stabbed by a, or if it starts after a but not after b.
+ * The intervals stabbed by the lower limits of the queries are found using the engine,
+ * i.e., only the lower limits are streamed to the AP, and the intervals which start inside the queries
+ * are found using binary searches over the sorted lower limits.
+ */
+template <typename LimitType>
+StabbedIntervals
+StabbingSession<LimitType>::overlap(
+  const Intervals<LimitType>& queries
+)
+{
+  StabbedIntervals stabs(query(lowerLimits(queries)));
+  if (m_lower.size() != m_intervals.count()) {
+    sortLimits();
+  }
+  auto pointBefore = [](const LimitType& point, const LimitIndex& limit) { return limitLess(point, limit.first); };
+  std::vector<StabbedIntervals> overlapping(m_numThreads);
+  parallelFor(m_numThreads, queries.count(),
+              [&](const unsigned t, const size_t first, const size_t last)
+              {
+                std::vector<size_t> offsets(1, 0);
+                offsets.reserve((last - first) + 1);
+                std::vector<size_t> indices, inserted;
+                for (size_t q = first; q < last; ++q) {
+                  const std::pair<LimitType, LimitType>& interval = queries.get(q);
+                  indices.insert(indices.end(), stabs.begin(q), stabs.end(q));
+                  typename std::vector<LimitIndex>::const_iterator begin, end;
+                  begin = std::upper_bound(m_lower.cbegin(), m_lower.cend(), interval.first, pointBefore);
+                  end = std::upper_bound(begin, m_lower.cend(), interval.second, pointBefore);
+                  for (; begin != end; ++begin) {
+                    if (!m_updated || !m_erased[begin->second]) {
+                      indices.push_back(begin->second);
+                    }
+                  }
+                  inserted.clear();
+                  m_insertedRuns.starting(interval.first, interval.second, inserted);
+                  for (const size_t& i : inserted) {
+                    if (!m_erased[i]) {
+                      indices.push_back(i);
+                    }
+                  }
+                  offsets.push_back(indices.size());
+                }
+                overlapping[t] = StabbedIntervals(std::move(offsets), std::move(indices));
+              });
+  return StabbedIntervals(std::move(overlapping));
+}
+
+/**
+ * @brief  Function for counting the intervals which overlap the given query intervals.
+ *
+ * @tparam LimitType  Datatype of the interval limits.
+ * @param  queries    Query intervals to be checked.
+ *
+ * @return  Number of intervals which overlap every query interval.
+ *
+ * The intervals stabbed by the lower limit of every query are counted using the engine,
+ * and the intervals which start inside the query are counted using binary searches.
+ */
+template <typename LimitType>
+std::vector<size_t>
+StabbingSession<LimitType>::countOverlaps(
+  const Intervals<LimitType>& queries
+)
+{
+  std::vector<size_t> counts(count(lowerLimits(queries)));
+  if (m_lower.size() != m_intervals.count()) {
+    sortLimits();
+  }
+  auto pointBefore = [](const LimitType& point, const LimitIndex& limit) { return limitLess(point, limit.first); };
+  parallelFor(m_numThreads, queries.count(),
+              [&](const unsigned, const size_t first, const size_t last)
+              {
+                for (size_t q = first; q < last; ++q) {
+                  const std::pair<LimitType, LimitType>& interval = queries.get(q);
+                  typename std::vector<LimitIndex>::const_iterator begin;
+                  begin = std::upper_bound(m_lower.cbegin(), m_lower.cend(), interval.first, pointBefore);
+                  counts[q] += std::upper_bound(begin, m_lower.cend(), interval.second, pointBefore) - begin;
+                  counts[q] += m_insertedRuns.countStarting(interval.first, interval.second);
+                  counts[q] -= m_erasedRuns.countStarting(interval.first, interval.second);
+                }
+              });
+  return counts;
+}
+
+/**
+ * @brief  Function for checking which of the given query intervals overlap any interval.
+ *
+ * @tparam LimitType  Datatype of the interval limits.
+ * @param  queries    Query intervals to be checked.
+ *
+ * @return  A bit for every query, which is set if the query overlaps at least one interval.
+ */
+template <typename LimitType>
+std::vector<bool>
+StabbingSession<LimitType>::anyOverlaps(
+  const Intervals<LimitType>& queries
+)
+{
+  std::vector<size_t> counts(countOverlaps(queries));
+  std::vector<bool> overlapping(counts.size());
+  for (size_t q = 0; q < counts.size(); ++q) {
+    overlapping[q] = (counts[q] > 0);
+  }
+  return overlapping;
+}
+
+/**
+ * @brief  Function for getting the intervals stabbed by a range of points from the reports of all the automata.
+ *
+ * @tparam LimitType   Datatype of the interval limits.
+ * @param  allReports  Reports of every automaton, in the order of offsets.
+ * @param  firstPoint  Index of the first point of the range in the stream from which the reports were generated.
+ * @param  numPoints   Number of points in the range.
+ *
+ * @return  Indices of the intervals which are stabbed by every point in the range.
+ *
+ * Reports from the comparators which don't have any intervals are ignored.
+ */
+template <typename LimitType>
+StabbedIntervals
+StabbingSession<LimitType>::decodeReports(
+  const std::vector<std::vector<Report> >& allReports,
+  const size_t firstPoint,
+  const size_t numPoints
+) const
+{
+  // Find the reports of the points in the range from every automaton.
+  auto firstOffset = [](const Report& report, const size_t offset) { return report.first <= offset; };
+  std::vector<std::pair<typename std::vector<Report>::const_iterator, typename std::vector<Report>::const_iterator> > ranges;
+  for (const std::vector<Report>& reports : allReports) {
+    typename std::vector<Report>::const_iterator begin, end;
+    begin = std::lower_bound(reports.begin(), reports.end(), firstPoint * B, firstOffset);
+    end = std::lower_bound(begin, reports.end(), (firstPoint + numPoints) * B, firstOffset);
+    ranges.push_back(std::make_pair(begin, end));
+  }
+  // Count the reports for every point before storing the stabbed intervals.
+  // The c-th comparator of the n-th automaton is the (n * m_perAutomaton + c)-th slot, which is programmed
+  // with the interval of the same index unless the intervals have been deduplicated or updated.
+  StabbedIntervals stabbedIntervals(numPoints);
+  for (size_t n = 0; n < ranges.size(); ++n) {
+    size_t limit = numComparators(n);
+    for (typename std::vector<Report>::const_iterator report = ranges[n].first; report != ranges[n].second; ++report) {
+      size_t comparator = m_elements.find(report->second);
+      if (comparator < limit) {
+        stabbedIntervals.count(((report->first - 1) / B) - firstPoint, numStabbed((n * m_perAutomaton) + comparator));
+      }
+    }
+  }
+  stabbedIntervals.allocate();
+  for (size_t n = 0; n < ranges.size(); ++n) {
+    size_t limit = numComparators(n);
+    for (typename std::vector<Report>::const_iterator report = ranges[n].first; report != ranges[n].second; ++report) {
+      size_t comparator = m_elements.find(report->second);
+      if (comparator < limit) {
+        addStabbed(stabbedIntervals, ((report->first - 1) / B) - firstPoint, (n * m_perAutomaton) + comparator);
+      }
+    }
+  }
+  return stabbedIntervals;
+}
+
+/**
+ * @brief  Function for counting the intervals stabbed by a range of points from the reports of all the automata.
+ *
+ * @tparam LimitType   Datatype of the interval limits.
+ * @param  allReports  Reports of every automaton, in the order of offsets.
+ * @param  firstPoint  Index of the first point in the range, relative to the offsets.
+ * @param  numPoints   Number of points in the range.
+ * @param  counts      Array in which the number of intervals stabbed by every point in the range is stored.
+ */
+template <typename LimitType>
+void
+StabbingSession<LimitType>::countReports(
+  const std::vector<std::vector<Report> >& allReports,
+  const size_t firstPoint,
+  const size_t numPoints,
+  size_t* const counts
+) const
+{
+  auto firstOffset = [](const Report& report, const size_t offset) { return report.first <= offset; };
+  std::fill(counts, counts + numPoints, 0);
+  for (size_t n = 0; n < allReports.size(); ++n) {
+    typename std::vector<Report>::const_iterator begin, end;
+    begin = std::lower_bound(allReports[n].begin(), allReports[n].end(), firstPoint * B, firstOffset);
+    end = std::lower_bound(begin, allReports[n].end(), (firstPoint + numPoints) * B, firstOffset);
+    size_t limit = numComparators(n);
+    for (typename std::vector<Report>::const_iterator report = begin; report != end; ++report) {
+      size_t comparator = m_elements.find(report->second);
+      if (comparator < limit) {
+        counts[((report->first - 1) / B) - firstPoint] += numStabbed((n * m_perAutomaton) + comparator);
+      }
+    }
+  }
+}
+
+/**
+ * @brief  Function for searching a stream of points on a device using all the automata assigned to it.
+ *
+ * @tparam LimitType  Datatype of the interval limits.
+ * @param  board      Device, or the simulators standing in for it.
+ * @param  stream     Stream of points.
+ *
+ * @return  Reports of every automaton assigned to the device, in the order of offsets.
+ *
+ * When the automata are loaded one after the other, the reports of an automaton are sorted
+ * and the next automaton is staged on the host while the device searches.
+ */
+template <typename LimitType>
+std::vector<std::vector<typename StabbingSession<LimitType>::Report> >
+StabbingSession<LimitType>::searchBoard(
+  Board& board,
+  const std::vector<unsigned char>& stream
+)
+{
+  std::vector<std::vector<Report> > allReports(board.automata.size());
+  if (allReports.empty()) {
+    return allReports;
+  }
+  if (!board.device) {
+    for (size_t n = 0; n < board.automata.size(); ++n) {
+      ProfiledPhase search("search", stream.size());
+      allReports[n] = m_simulators[board.automata[n]].search(stream, m_flowChunkSize);
+    }
+  }
+  else if (board.loaded) {
+    ProfiledPhase search("search", stream.size());
+    allReports.front() = board.device->search(stream, m_flowChunkSize);
+    search.stop();
+    sortReports(allReports.front());
+  }
+  else {
+    std::unique_ptr<ap::Automaton> staged(new ap::Automaton(m_automata[board.automata.front()]));
+    for (size_t n = 0; n < board.automata.size(); ++n) {
+      ProfiledPhase load("load");
+      board.device->load(*staged);
+      load.stop();
+      // Sort the reports of the previous automaton and stage the next automaton during the search.
+      auto stage = [this, &board, &allReports, n]()
+                   {
+                     if (n > 0) {
+                       sortReports(allReports[n - 1]);
+                     }
+                     bool last = (n + 1 == board.automata.size());
+                     return std::unique_ptr<ap::Automaton>(last ? nullptr : new ap::Automaton(m_automata[board.automata[n + 1]]));
+                   };
+      std::future<std::unique_ptr<ap::Automaton> > next = std::async(std::launch::async, stage);
+      ProfiledPhase search("search", stream.size());
+      allReports[n] = board.device->search(stream, m_flowChunkSize);
+      search.stop();
+      board.device->unload();
+      staged = next.get();
+    }
+    sortReports(allReports.back());
+  }
+  return allReports;
+}
+
+/**
+ * @brief  Function for streaming a range of points to the given devices in a pipeline.
+ *
+ * @tparam LimitType   Datatype of the interval limits.
+ * @param  points      Points to be checked.
+ * @param  firstPoint  Index of the first point in the range.
+ * @param  lastPoint   Index after the last point in the range.
+ * @param  boards      Indices of the devices which search the points.
+ * @param  numThreads  Number of threads used for building the streams and decoding the reports.
+ * @param  counts      Array in which the number of intervals stabbed by every point in the range is stored.
+ *                     nullptr if the stabbed intervals should be returned instead.
+ *
+ * @return  Indices of the intervals which are stabbed by every point in the range, if they aren't counted.
+ *
+ * The points are streamed in chunks. The stream for the next chunk is built and the reports for the previous
+ * chunk are decoded on their own threads while the devices search the current chunk. Bounded queues
+ * limit the number of chunks in flight, so that the memory used by the streams and the reports doesn't grow
+ * with the number of points. All the points are streamed at once if the automata of any of the devices are
+ * loaded one after the other, so that they are loaded only once.
+ */
+template <typename LimitType>
+StabbedIntervals
+StabbingSession<LimitType>::streamPoints(
+  const Points<LimitType>& points,
+  const size_t firstPoint,
+  const size_t lastPoint,
+  const std::vector<size_t>& boards,
+  const unsigned numThreads,
+  size_t* const counts
+)
+{
+  size_t chunkPoints = ((m_flowChunkSize < PipelineChunkSize) ? m_flowChunkSize : PipelineChunkSize) / B;
+  for (size_t d : boards) {
+    if (m_boards[d].device && !m_boards[d].loaded) {
+      chunkPoints = lastPoint - firstPoint;
+    }
+  }
+  chunkPoints = std::max(chunkPoints, static_cast<size_t>(1));
+  size_t numChunks = (lastPoint - firstPoint + chunkPoints - 1) / chunkPoints;
+
+  BoundedQueue<std::vector<unsigned char> > streams(PipelineDepth);
+  BoundedQueue<std::pair<size_t, std::vector<std::vector<Report> > > > chunkReports(PipelineDepth);
+  std::vector<StabbedIntervals> stabbedIntervals;
+  // Build the byte streams for the chunks of points.
+  auto build = [&]()
+               {
+                 try {
+                   for (size_t c = 0; c < numChunks; ++c) {
+                     size_t chunkFirst = firstPoint + (c * chunkPoints);
+                     size_t chunkLast = std::min(chunkFirst + chunkPoints, lastPoint);
+                     std::vector<unsigned char> chunkStream((chunkLast - chunkFirst)*B);
+                     parallelFor(numThreads, chunkLast - chunkFirst,
+                                 [&](const unsigned, const size_t first, const size_t last)
+                                 {
+                                   reverse_memcpy_n(chunkStream.data() + (first * B), points.data() + chunkFirst + first, last - first, B);
+                                 });
+                     if (!streams.push(std::move(chunkStream))) {
+                       break;
+                     }
+                   }
+                 }
+                 catch (...) {
+                   streams.close();
+                   throw;
+                 }
+                 streams.close();
+               };
+  // Decode the reports for the chunks of points.
+  auto decode = [&]()
+                {
+                  try {
+                    std::pair<size_t, std::vector<std::vector<Report> > > reports;
+                    size_t decodedPoints = 0;
+                    while (chunkReports.pop(reports)) {
+                      size_t numReports = 0;
+                      for (const std::vector<Report>& automatonReports : reports.second) {
+                        numReports += automatonReports.size();
+                      }
+                      Profiler::addCount("reports", numReports);
+                      ProfiledPhase decoding("decode", numReports * sizeof(Report));
+                      std::vector<StabbedIntervals> parts(numThreads);
+                      parallelFor(numThreads, reports.first,
+                                  [&](const unsigned t, const size_t first, const size_t last)
+                                  {
+                                    if (counts != nullptr) {
+                                      countReports(reports.second, first, last - first, counts + decodedPoints + first);
+                                    }
+                                    else {
+                                      parts[t] = decodeReports(reports.second, first, last - first);
+                                    }
+                                  });
+                      if (counts == nullptr) {
+                        stabbedIntervals.push_back(StabbedIntervals(std::move(parts)));
+                      }
+                      decodedPoints += reports.first;
+                    }
+                  }
+                  catch (...) {
+                    chunkReports.close();
+                    throw;
+                  }
+                };
+  std::future<void> built = std::async(std::launch::async, build);
+  std::future<void> decoded = std::async(std::launch::async, decode);
+
+  // Search every chunk of points on all the devices, each from its own thread.
+  try {
+    std::vector<unsigned char> stream;
+    while (streams.pop(stream)) {
+      std::vector<std::vector<Report> > allReports(m_numAutomata);
+      parallelFor(boards.size(), boards.size(),
+                  [&](const unsigned, const size_t first, const size_t last)
+                  {
+                    for (size_t d = first; d < last; ++d) {
+                      Board& board = m_boards[boards[d]];
+                      std::vector<std::vector<Report> > boardReports = searchBoard(board, stream);
+                      for (size_t n = 0; n < boardReports.size(); ++n) {
+                        allReports[board.automata[n]] = std::move(boardReports[n]);
+                      }
+                    }
+                  });
+      if (!chunkReports.push(std::make_pair(stream.size() / B, std::move(allReports)))) {
+        break;
+      }
+    }
+  }
+  catch (...) {
+    streams.close();
+    chunkReports.close();
+    built.wait();
+    decoded.wait();
+    throw;
+  }
+  streams.close();
+  chunkReports.close();
+  built.get();
+  decoded.get();
+  return StabbedIntervals(std::move(stabbedIntervals));
+}
+
+/**
+ * @brief  Function for checking which intervals are stabbed by the given points, using the automata.
+ *
+ * @tparam LimitType  Datatype of the interval limits.
+ * @param  points     Points to be checked.
+ * @param  counts     Array in which the number of intervals stabbed by every point is stored.
+ *                    nullptr if the stabbed intervals should be returned instead.
+ *
+ * @return  Indices of the intervals which are stabbed by every point, if they aren't counted.
+ *
+ * Every device is driven from its own thread. The comparators changed by any updates are relabeled first.
+ */
+template <typename LimitType>
+StabbedIntervals
+StabbingSession<LimitType>::queryAutomaton(
+  const Points<LimitType>& points,
+  size_t* const counts
+)
+{
+  applyUpdates();
+  unsigned numBoards = m_boards.size();
+  if (m_splitPoints) {
+    // Every device searches its own range of points using all the automata.
+    unsigned boardThreads = std::max(m_numThreads / numBoards, 1u);
+    std::vector<StabbedIntervals> stabbedIntervals(numBoards);
+    parallelFor(numBoards, points.count(),
+                [&](const unsigned t, const size_t first, const size_t last)
+                {
+                  size_t* const rangeCounts = (counts != nullptr) ? (counts + first) : nullptr;
+                  stabbedIntervals[t] = streamPoints(points, first, last, std::vector<size_t>(1, t), boardThreads, rangeCounts);
+                });
+    return StabbedIntervals(std::move(stabbedIntervals));
+  }
+  else {
+    // Every device searches all the points using its own automata.
+    std::vector<size_t> boards(numBoards);
+    for (size_t d = 0; d < numBoards; ++d) {
+      boards[d] = d;
+    }
+    return streamPoints(points, 0, points.count(), boards, m_numThreads, counts);
+  }
+}
+
+/**
+ * @brief  Function for checking which intervals are stabbed by the given points, using an interval tree.
+ *
+ * @tparam LimitType  Datatype of the interval limits.
+ * @param  points     Points to be checked.
+ *
+ * @return  Indices of the intervals which are stabbed by every point.
+ */
+template <typename LimitType>
+StabbedIntervals
+StabbingSession<LimitType>::queryTree(
+  const Points<LimitType>& points
+) const
+{
+  std::vector<StabbedIntervals> stabbedIntervals(m_numThreads);
+  parallelFor(m_numThreads, points.count(),
+              [&](const unsigned t, const size_t first, const size_t last)
+              {
+                // Stabs of the points are found in order and therefore, are directly appended.
+                std::vector<size_t> offsets(1, 0);
+                offsets.reserve((last - first) + 1);
+                std::vector<size_t> indices;
+                for (size_t p = first; p < last; ++p) {
+                  m_tree->stab(points.get(p), indices);
+                  offsets.push_back(indices.size());
+                }
+                stabbedIntervals[t] = StabbedIntervals(std::move(offsets), std::move(indices));
+              });
+  return StabbedIntervals(std::move(stabbedIntervals));
+}
+
+/**
+ * @brief  Function for checking which intervals are stabbed by the given points,
+ *         by sweeping over the sorted points and limits of the intervals together.
+ *
+ * @tparam LimitType  Datatype of the interval limits.
+ * @param  points     Points to be checked.
+ *
+ * @return  Indices of the intervals which are stabbed by every point.
+ */
+template <typename LimitType>
+StabbedIntervals
+StabbingSession<LimitType>::querySweep(
+  const Points<LimitType>& points
+) const
+{
+  auto compareLimits = [](const LimitIndex& a, const LimitIndex& b) { return limitLess(a.first, b.first); };
+  auto limitBefore = [](const LimitIndex& limit, const LimitType& point) { return limitLess(limit.first, point); };
+  auto pointBefore = [](const LimitType& point, const LimitIndex& limit) { return limitLess(point, limit.first); };
+
+  // The points are sorted once and every thread sweeps over its own range of the sorted points.
+  std::vector<LimitIndex> sortedPoints(points.count());
+  parallelFor(m_numThreads, points.count(),
+              [&](const unsigned, const size_t first, const size_t last)
+              {
+                for (size_t p = first; p < last; ++p) {
+                  sortedPoints[p] = std::make_pair(points.get(p), p);
+                }
+              });
+  std::sort(sortedPoints.begin(), sortedPoints.end(), compareLimits);
+
+  // Every interval which starts at or before a point and doesn't end before it is stabbed by the point.
+  StabbedIntervals stabs(points.count());
+  parallelFor(m_numThreads, sortedPoints.size(),
+              [&](const unsigned, const size_t first, const size_t last)
+              {
+                for (size_t r = first; r < last; ++r) {
+                  size_t started = std::upper_bound(m_lower.begin(), m_lower.end(), sortedPoints[r].first, pointBefore) - m_lower.begin();
+                  size_t ended = std::lower_bound(m_upper.begin(), m_upper.end(), sortedPoints[r].first, limitBefore) - m_upper.begin();
+                  stabs.count(sortedPoints[r].second, started - ended);
+                }
+              });
+  stabs.allocate();
+
+  parallelFor(m_numThreads, sortedPoints.size(),
+              [&](const unsigned, const size_t first, const size_t last)
+              {
+                if (first == last) {
+                  return;
+                }
+                // Limits which are before the first point of the range, and the upper limits which are before its last point.
+                const LimitType& firstPoint = sortedPoints[first].first;
+                size_t l = std::upper_bound(m_lower.begin(), m_lower.end(), firstPoint, pointBefore) - m_lower.begin();
+                size_t u = std::lower_bound(m_upper.begin(), m_upper.end(), firstPoint, limitBefore) - m_upper.begin();
+                const size_t firstEnded = u;
+                const size_t lastEnded = std::lower_bound(m_upper.begin() + u, m_upper.end(), sortedPoints[last - 1].first, limitBefore) - m_upper.begin();
+
+                // Intervals which contain the current point. Only the intervals which end within the range
+                // are deactivated, so only their positions in the active list are kept, by their upper limits.
+                std::vector<size_t> active;
+                std::vector<size_t> position(lastEnded - firstEnded);
+                auto activate = [&](const size_t i)
+                                {
+                                  const size_t rank = m_upperRanks[i];
+                                  if ((rank >= firstEnded) && (rank < lastEnded)) {
+                                    position[rank - firstEnded] = active.size();
+                                  }
+                                  active.push_back(i);
+                                };
+                // The active list is seeded by stabbing the first point, scanning whichever of the started
+                // and the not yet ended intervals are fewer.
+                if (l <= (m_upper.size() - u)) {
+                  for (size_t s = 0; s < l; ++s) {
+                    if (!limitLess(m_intervals.get(m_lower[s].second).second, firstPoint)) {
+                      activate(m_lower[s].second);
+                    }
+                  }
+                }
+                else {
+                  for (size_t e = u; e < m_upper.size(); ++e) {
+                    if (!limitLess(firstPoint, m_intervals.get(m_upper[e].second).first)) {
+                      activate(m_upper[e].second);
+                    }
+                  }
+                }
+
+                for (size_t r = first; r < last; ++r) {
+                  const LimitIndex& point = sortedPoints[r];
+                  // Activate all the intervals which start at or before the point.
+                  for (; (l < m_lower.size()) && !limitLess(point.first, m_lower[l].first); ++l) {
+                    activate(m_lower[l].second);
+                  }
+                  // Deactivate all the intervals which end before the point.
+                  for (; (u < m_upper.size()) && limitLess(m_upper[u].first, point.first); ++u) {
+                    const size_t hole = position[u - firstEnded];
+                    const size_t back = active.back();
+                    active[hole] = back;
+                    const size_t backRank = m_upperRanks[back];
+                    if ((backRank >= firstEnded) && (backRank < lastEnded)) {
+                      position[backRank - firstEnded] = hole;
+                    }
+                    active.pop_back();
+                  }
+                  for (const size_t& i : active) {
+                    stabs.add(point.second, i);
+                  }
+                }
+              });
+  return stabs;
+}
+
+/**
+ * @brief  Function for updating the intervals stabbed by the given points with the inserted and the erased intervals.
+ *
+ * @tparam LimitType  Datatype of the interval limits.
+ * @param  points     Points which were checked.
+ * @param  stabs      Indices of the intervals given to the session which are stabbed by every point.
+ *                    They are freed before the updated indices are concatenated.
+ *
+ * @return  Indices of the intervals which are stabbed by every point, excluding the erased intervals.
+ */
+template <typename LimitType>
+StabbedIntervals
+StabbingSession<LimitType>::updateStabs(
+  const Points<LimitType>& points,
+  StabbedIntervals&& stabs
+) const
+{
+  std::vector<StabbedIntervals> stabbedIntervals(m_numThreads);
+  parallelFor(m_numThreads, points.count(),
+              [&](const unsigned t, const size_t first, const size_t last)
+              {
+                std::vector<size_t> offsets(1, 0);
+                offsets.reserve((last - first) + 1);
+                std::vector<size_t> indices, inserted;
+                for (size_t p = first; p < last; ++p) {
+                  for (const size_t* i = stabs.begin(p); i != stabs.end(p); ++i) {
+                    if (!m_erased[*i]) {
+                      indices.push_back(*i);
+                    }
+                  }
+                  inserted.clear();
+                  m_insertedRuns.stab(points.get(p), inserted);
+                  for (const size_t& i : inserted) {
+                    if (!m_erased[i]) {
+                      indices.push_back(i);
+                    }
+                  }
+                  offsets.push_back(indices.size());
+                }
+                stabbedIntervals[t] = StabbedIntervals(std::move(offsets), std::move(indices));
+              });
+  stabs = StabbedIntervals();
+  return StabbedIntervals(std::move(stabbedIntervals));
+}
+
+/**
+ * @brief  Function for counting the intervals which are stabbed by the given points, using the sorted limits.
+ *
+ * @tparam LimitType  Datatype of the interval limits.
+ * @param  points     Points to be checked.
+ * @param  counts     Array in which the number of intervals stabbed by every point is stored.
+ *
+ * An interval is stabbed by a point if its lower limit isn't after the point and its upper limit isn't before it.
+ * Since every interval which ends before the point also starts before it, the number of stabbed intervals is
+ * the number of lower limits not after the point minus the number of upper limits before the point.
+ * The limits are sorted on the first call for the interval tree engine.
+ * The inserted intervals are added to the counts, and the erased intervals are subtracted from them.
+ */
+template <typename LimitType>
+void
+StabbingSession<LimitType>::countLimits(
+  const Points<LimitType>& points,
+  size_t* const counts
+)
+{
+  if (m_lower.size() != m_intervals.count()) {
+    sortLimits();
+  }
+  auto limitBefore = [](const LimitIndex& limit, const LimitType& point) { return limitLess(limit.first, point); };
+  auto pointBefore = [](const LimitType& point, const LimitIndex& limit) { return limitLess(point, limit.first); };
+  parallelFor(m_numThreads, points.count(),
+              [&](const unsigned, const size_t first, const size_t last)
+              {
+                for (size_t p = first; p < last; ++p) {
+                  const LimitType& point = points.get(p);
+                  size_t started = std::upper_bound(m_lower.begin(), m_lower.end(), point, pointBefore) - m_lower.begin();
+                  size_t ended = std::lower_bound(m_upper.begin(), m_upper.end(), point, limitBefore) - m_upper.begin();
+                  counts[p] = (started - ended) + m_insertedRuns.count(point) - m_erasedRuns.count(point);
+                }
+              });
+}
+
+/**
+ * @brief  Destructor, which unloads the automata from the devices.
+ *
+ * @tparam LimitType  Datatype of the interval limits.
+ */
+template <typename LimitType>
+StabbingSession<LimitType>::~StabbingSession(
+)
+{
+  for (Board& board : m_boards) {
+    if (board.loaded) {
+      board.device->unload();
+    }
+  }
+}
+
+// Explicit class instantiation.
+template class StabbingSession<uint32_t>;
+template class StabbingSession<int32_t>;
+template class StabbingSession<uint64_t>;
+template class StabbingSession<int64_t>;
+template class StabbingSession<float>;
+template class StabbingSession<double>;
@@ -0,0 +1,197 @@
+/**
+ * @file StabbingSession.hpp
+ * @brief Declaration of StabbingSession functions.
+ * @author Ankit Srivastava <asrivast@gatech.edu>
+ *
+ * Copyright 2018 Georgia Institute of Technology
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef STABBINGSESSION_HPP_
+#define STABBINGSESSION_HPP_
+
+#include "apsdk/Device.hpp"
+#include "AutomatonSimulator.hpp"
+#include "ElementTable.hpp"
+#include "Intervals.hpp"
+#include "IntervalRuns.hpp"
+#include "IntervalTree.hpp"
+#include "Points.hpp"
+#include "StabbedIntervals.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+
+/**
+ * @brief  Class for stabbing a fixed set of intervals with many batches of points.
+ *
+ * @tparam LimitType  Datatype of the limits of the intervals.
+ *
+ * Everything that depends only on the intervals, e.g., the automaton loaded on the device,
+ * the simulator, the interval tree, or the sorted limits, is prepared once when the session is created.
+ * The points are streamed to the devices in chunks through a pipeline.
+ * If the intervals need more than one automaton, the points are streamed through all of them one after the other.
+ * With more than one device, either the automata are sharded across the devices and every device searches
+ * all the points, or the automata are replicated and every device searches a range of the points.
+ * Intervals can be inserted and erased after the session is created. The AP engine programs the inserted
+ * intervals on spare comparators, and the other engines keep them in a separate, growing index.
+ * Besides points, the intervals can also be queried with intervals, for finding all the overlapping intervals.
+ * The intervals must outlive the session.
+ */
+template <typename LimitType>
+class StabbingSession {
+public:
+  StabbingSession(const Intervals<LimitType>&, const std::string&, const std::vector<std::string>&, const std::string&, const std::string&, const std::string&, const std::string&, const size_t, const size_t, const size_t, const unsigned);
+
+  size_t
+  insert(const std::pair<LimitType, LimitType>&);
+
+  void
+  erase(const size_t);
+
+  const std::pair<LimitType, LimitType>&
+  get(const size_t) const;
+
+  size_t
+  size() const;
+
+  StabbedIntervals
+  query(const Points<LimitType>&);
+
+  std::vector<size_t>
+  count(const Points<LimitType>&);
+
+  std::vector<bool>
+  any(const Points<LimitType>&);
+
+  StabbedIntervals
+  overlap(const Intervals<LimitType>&);
+
+  std::vector<size_t>
+  countOverlaps(const Intervals<LimitType>&);
+
+  std::vector<bool>
+  anyOverlaps(const Intervals<LimitType>&);
+
+  ~StabbingSession();
+
+private:
+  static const size_t B = sizeof(LimitType);
+  // Maximum size of the chunks of points streamed through the pipeline.
+  static const size_t PipelineChunkSize = 1 << 24;
+  // Maximum number of chunks waiting between the stages of the pipeline.
+  static const size_t PipelineDepth = 2;
+  // Marker for the end of a list of intervals.
+  static const size_t None = static_cast<size_t>(-1);
+
+private:
+  typedef std::pair<LimitType, size_t> LimitIndex;
+  typedef std::pair<size_t, ap::ElementRef> Report;
+
+  /**
+   * @brief  AP device, or the simulators standing in for it, along with the automata assigned to it.
+   */
+  struct Board {
+    std::unique_ptr<ap::Device> device;
+    std::vector<size_t> automata;
+    bool loaded;
+  };
+
+private:
+  StabbingSession(const StabbingSession&);
+
+  StabbingSession&
+  operator=(const StabbingSession&);
+
+  void
+  sortLimits();
+
+  void
+  prepareUpdates();
+
+  void
+  applyUpdates();
+
+  size_t
+  numComparators(const size_t) const;
+
+  size_t
+  numStabbed(const size_t) const;
+
+  void
+  addStabbed(StabbedIntervals&, const size_t, const size_t) const;
+
+  StabbedIntervals
+  decodeReports(const std::vector<std::vector<Report> >&, const size_t, const size_t) const;
+
+  void
+  countReports(const std::vector<std::vector<Report> >&, const size_t, const size_t, size_t* const) const;
+
+  std::vector<std::vector<Report> >
+  searchBoard(Board&, const std::vector<unsigned char>&);
+
+  StabbedIntervals
+  streamPoints(const Points<LimitType>&, const size_t, const size_t, const std::vector<size_t>&, const unsigned, size_t* const);
+
+  StabbedIntervals
+  queryAutomaton(const Points<LimitType>&, size_t* const);
+
+  StabbedIntervals
+  queryTree(const Points<LimitType>&) const;
+
+  StabbedIntervals
+  querySweep(const Points<LimitType>&) const;
+
+  StabbedIntervals
+  updateStabs(const Points<LimitType>&, StabbedIntervals&&) const;
+
+  void
+  countLimits(const Points<LimitType>&, size_t* const);
+
+private:
+  const Intervals<LimitType>& m_intervals;
+  std::string m_engine;
+  std::string m_macrosDir;
+  size_t m_numSpares;
+  size_t m_flowChunkSize;
+  unsigned m_numThreads;
+  bool m_splitPoints;
+  Intervals<LimitType> m_distinct;
+  std::vector<size_t> m_duplicateOffsets;
+  std::vector<size_t> m_duplicateIndices;
+  const Intervals<LimitType>* m_programmed;
+  ElementTable m_elements;
+  size_t m_perAutomaton;
+  size_t m_numAutomata;
+  std::vector<ap::Automaton> m_automata;
+  std::vector<AutomatonSimulator<LimitType> > m_simulators;
+  std::vector<Board> m_boards;
+  std::unique_ptr<IntervalTree<LimitType> > m_tree;
+  std::vector<LimitIndex> m_lower;
+  std::vector<LimitIndex> m_upper;
+  std::vector<size_t> m_upperRanks;
+  bool m_updated;
+  std::vector<std::pair<LimitType, LimitType> > m_inserted;
+  std::vector<bool> m_erased;
+  std::vector<size_t> m_slotHeads;
+  std::vector<size_t> m_nextDuplicate;
+  std::vector<size_t> m_slots;
+  std::vector<size_t> m_freeSlots;
+  std::vector<size_t> m_changedSlots;
+  IntervalRuns<LimitType> m_insertedRuns;
+  IntervalRuns<LimitType> m_erasedRuns;
+}; // class StabbingSession
+
+#endif // STABBINGSESSION_HPP_
@@ -0,0 +1,301 @@
+/**
+ * @file TextParser.hpp
+ * @brief Declaration and implementation of functions for parsing text files.
+ * @author Ankit Srivastava <asrivast@gatech.edu>
+ *
+ * Copyright 2018 Georgia Institute of Technology
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef TEXTPARSER_HPP_
+#define TEXTPARSER_HPP_
+
+#include "Parallel.hpp"
+
+#include <array>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+/**
+ * @brief  Function for checking if the given character separates values on a line.
+ */
+inline
+bool
+isBlank(
+  const char c
+)
+{
+  return (c == ' ') || (c == '\t') || (c == '\r');
+}
+
+/**
+ * @brief  Function for parsing an integer value.
+ *
+ * @tparam ValueType  Integer type of the value.
+ * @param p           Pointer to the first character of the value, advanced past the parsed characters.
+ * @param last        Pointer to the end of the line.
+ * @param value       Parsed value.
+ *
+ * @return  true if a value in the range of the type was parsed.
+ */
+template <typename ValueType>
+bool
+parseNumber(
+  const char*& p,
+  const char* const last,
+  ValueType& value,
+  std::true_type
+)
+{
+  typedef typename std::make_unsigned<ValueType>::type UnsignedType;
+  bool negative = false;
+  if ((p != last) && ((*p == '-') || (*p == '+'))) {
+    negative = (*p == '-');
+    ++p;
+  }
+  if ((negative && !std::is_signed<ValueType>::value) || (p == last) || (*p < '0') || (*p > '9')) {
+    return false;
+  }
+  UnsignedType limit = static_cast<UnsignedType>(std::numeric_limits<ValueType>::max());
+  if (negative) {
+    limit += 1;
+  }
+  UnsignedType magnitude = 0;
+  for (; (p != last) && (*p >= '0') && (*p <= '9'); ++p) {
+    UnsignedType digit = static_cast<UnsignedType>(*p - '0');
+    if (magnitude > (limit - digit) / 10) {
+      return false;
+    }
+    magnitude = (magnitude * 10) + digit;
+  }
+  value = static_cast<ValueType>(negative ? (UnsignedType(0) - magnitude) : magnitude);
+  return true;
+}
+
+/**
+ * @brief  Functions for converting the text at the given pointer to a real value.
+ */
+inline
+void
+toReal(
+  const char* p,
+  char** end,
+  float& value
+)
+{
+  value = std::strtof(p, end);
+}
+
+inline
+void
+toReal(
+  const char* p,
+  char** end,
+  double& value
+)
+{
+  value = std::strtod(p, end);
+}
+
+/**
+ * @brief  Function for parsing a real value.
+ *
+ * @tparam ValueType  Real type of the value.
+ * @param p           Pointer to the first character of the value, advanced past the parsed characters.
+ * @param last        Pointer to the end of the line. The text must be null terminated somewhere after it.
+ * @param value       Parsed value.
+ *
+ * @return  true if a value was parsed.
+ */
+template <typename ValueType>
+bool
+parseNumber(
+  const char*& p,
+  const char* const last,
+  ValueType& value,
+  std::false_type
+)
+{
+  char* end = nullptr;
+  toReal(p, &end, value);
+  if ((end == p) || (end > last)) {
+    return false;
+  }
+  p = end;
+  return true;
+}
+
+/**
+ * @brief  Function for parsing the next whitespace separated value on a line.
+ *
+ * @tparam ValueType  Type of the value.
+ * @param p           Pointer into the line, advanced past the parsed value.
+ * @param last        Pointer to the end of the line.
+ * @param value       Parsed value.
+ *
+ * @return  true if a value was parsed.
+ */
+template <typename ValueType>
+bool
+parseValue(
+  const char*& p,
+  const char* const last,
+  ValueType& value
+)
+{
+  while ((p != last) && isBlank(*p)) {
+    ++p;
+  }
+  if ((p == last) || !parseNumber(p, last, value, typename std::is_integral<ValueType>::type())) {
+    return false;
+  }
+  return (p == last) || isBlank(*p);
+}
+
+/**
+ * @brief  Functions for parsing a record, i.e., a point or an interval, or an array of them, from a line.
+ *
+ * @return  true if the record was parsed. Any text after the record is ignored.
+ */
+template <typename ValueType>
+bool
+parseRecord(
+  const char*& p,
+  const char* const last,
+  ValueType& value
+)
+{
+  return parseValue(p, last, value);
+}
+
+template <typename ValueType>
+bool
+parseRecord(
+  const char*& p,
+  const char* const last,
+  std::pair<ValueType, ValueType>& interval
+)
+{
+  return parseValue(p, last, interval.first) && parseValue(p, last, interval.second);
+}
+
+template <typename ValueType, size_t N>
+bool
+parseRecord(
+  const char*& p,
+  const char* const last,
+  std::array<ValueType, N>& values
+)
+{
+  for (ValueType& value : values) {
+    if (!parseRecord(p, last, value)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief  Function for getting the position of the first line starting at or after the given position.
+ */
+inline
+size_t
+lineStart(
+  const std::string& text,
+  const size_t position
+)
+{
+  if (position == 0) {
+    return 0;
+  }
+  const void* newline = memchr(text.data() + position - 1, '\n', text.size() - position + 1);
+  return (newline != nullptr) ? (static_cast<const char*>(newline) - text.data() + 1) : text.size();
+}
+
+/**
+ * @brief  Function for parsing a text file with one record per line, using multiple threads.
+ *
+ * @tparam RecordType  Type of the records, either a value or a pair of values.
+ * @param fileName     Name of the file to be parsed.
+ * @param numThreads   Number of threads to be used (0 for all the hardware threads).
+ * @param records      Container to which the records are appended, in the order of the lines.
+ *
+ * The file is split into chunks of lines, which are parsed on their own threads.
+ * Blank lines are skipped, and a line which doesn't start with a valid record is an error.
+ */
+template <typename RecordType>
+void
+parseTextFile(
+  const std::string& fileName,
+  const unsigned numThreads,
+  std::vector<RecordType>& records
+)
+{
+  std::ifstream file(fileName, std::ios::binary);
+  if (!file) {
+    throw std::runtime_error("Couldn't open the file " + fileName + ".");
+  }
+  file.seekg(0, std::ios::end);
+  std::string text(static_cast<size_t>(file.tellg()), '\0');
+  file.seekg(0, std::ios::beg);
+  file.read(&text[0], text.size());
+  if (!file) {
+    throw std::runtime_error("Couldn't read the file " + fileName + ".");
+  }
+
+  unsigned threads = getNumThreads(numThreads);
+  std::vector<std::vector<RecordType> > parts(threads);
+  parallelFor(threads, text.size(),
+              [&](const unsigned t, const size_t first, const size_t last)
+              {
+                const char* p = text.data() + lineStart(text, first);
+                const char* const end = text.data() + lineStart(text, last);
+                std::vector<RecordType>& part = parts[t];
+                part.reserve((end - p) / (8 * sizeof(RecordType)));
+                while (p < end) {
+                  const char* const line = p;
+                  const void* newline = memchr(p, '\n', end - p);
+                  const char* const eol = (newline != nullptr) ? static_cast<const char*>(newline) : end;
+                  while ((p != eol) && isBlank(*p)) {
+                    ++p;
+                  }
+                  if (p != eol) {
+                    RecordType record;
+                    if (!parseRecord(p, eol, record)) {
+                      throw std::runtime_error("Couldn't parse the line \"" + std::string(line, eol) + "\" in the file " + fileName + ".");
+                    }
+                    part.push_back(record);
+                  }
+                  p = eol + 1;
+                }
+              });
+
+  size_t total = records.size();
+  for (const std::vector<RecordType>& part : parts) {
+    total += part.size();
+  }
+  records.reserve(total);
+  for (const std::vector<RecordType>& part : parts) {
+    records.insert(records.end(), part.begin(), part.end());
+  }
+}
+
+#endif // TEXTPARSER_HPP_
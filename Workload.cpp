@@ -0,0 +1,540 @@
+/**
+ * @file Workload.cpp
+ * @brief Implementation of Workload functions.
+ * @author Ankit Srivastava <asrivast@gatech.edu>
+ *
+ * Copyright 2018 Georgia Institute of Technology
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "Workload.hpp"
+#include "BinaryFile.hpp"
+#include "Parallel.hpp"
+#include "Profiler.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+
+
+/**
+ * @brief  Functions for getting the lowest and the highest values which are generated for a datatype.
+ */
+template <typename LimitType>
+static
+typename std::enable_if<std::is_integral<LimitType>::value, LimitType>::type
+lowestValue(
+)
+{
+  return std::numeric_limits<LimitType>::min();
+}
+
+template <typename LimitType>
+static
+typename std::enable_if<std::is_floating_point<LimitType>::value, LimitType>::type
+lowestValue(
+)
+{
+  return -(std::numeric_limits<LimitType>::max() / 2);
+}
+
+template <typename LimitType>
+static
+LimitType
+highestValue(
+)
+{
+  return std::is_integral<LimitType>::value ? std::numeric_limits<LimitType>::max() : (std::numeric_limits<LimitType>::max() / 2);
+}
+
+/**
+ * @brief  Functions for drawing a value uniformly from the given range.
+ */
+template <typename LimitType, typename RandomNumberGenerator>
+static
+typename std::enable_if<std::is_integral<LimitType>::value, LimitType>::type
+uniformValue(
+  const LimitType low,
+  const LimitType high,
+  RandomNumberGenerator& generator
+)
+{
+  return std::uniform_int_distribution<LimitType>(low, high)(generator);
+}
+
+template <typename LimitType, typename RandomNumberGenerator>
+static
+typename std::enable_if<std::is_floating_point<LimitType>::value, LimitType>::type
+uniformValue(
+  const LimitType low,
+  const LimitType high,
+  RandomNumberGenerator& generator
+)
+{
+  return std::uniform_real_distribution<LimitType>(low, high)(generator);
+}
+
+/**
+ * @brief  Functions for drawing an interval of the given length uniformly from the whole range.
+ */
+template <typename LimitType, typename RandomNumberGenerator>
+static
+typename std::enable_if<std::is_integral<LimitType>::value, std::pair<LimitType, LimitType> >::type
+intervalOfLength(
+  const double length,
+  RandomNumberGenerator& generator
+)
+{
+  // Unsigned arithmetic is used so that the width of the range of signed datatypes doesn't overflow.
+  typedef typename std::make_unsigned<LimitType>::type UnsignedType;
+  const UnsignedType low = static_cast<UnsignedType>(lowestValue<LimitType>());
+  const UnsignedType width = static_cast<UnsignedType>(highestValue<LimitType>()) - low;
+  const UnsignedType span = (length < static_cast<double>(width)) ? static_cast<UnsignedType>(length) : width;
+  const UnsignedType lower = low + std::uniform_int_distribution<UnsignedType>(0, width - span)(generator);
+  return std::make_pair(static_cast<LimitType>(lower), static_cast<LimitType>(lower + span));
+}
+
+template <typename LimitType, typename RandomNumberGenerator>
+static
+typename std::enable_if<std::is_floating_point<LimitType>::value, std::pair<LimitType, LimitType> >::type
+intervalOfLength(
+  const double length,
+  RandomNumberGenerator& generator
+)
+{
+  const LimitType low = lowestValue<LimitType>(), high = highestValue<LimitType>();
+  const LimitType span = std::min(static_cast<LimitType>(length), high - low);
+  const LimitType lower = uniformValue(low, high - span, generator);
+  return std::make_pair(lower, std::min(lower + span, high));
+}
+
+/**
+ * @brief  Function for converting a location to a value of the datatype, clamped to the range.
+ *
+ * @tparam LimitType  Datatype of the value.
+ * @param  location   Location in the range.
+ */
+template <typename LimitType>
+static
+LimitType
+clampedValue(
+  const double location
+)
+{
+  if (!(location > static_cast<double>(lowestValue<LimitType>()))) {
+    return lowestValue<LimitType>();
+  }
+  if (!(location < static_cast<double>(highestValue<LimitType>()))) {
+    return highestValue<LimitType>();
+  }
+  return static_cast<LimitType>(location);
+}
+
+/**
+ * @brief  Function for getting the random number generator for a block of records.
+ *
+ * @param seed    Seed of the workload.
+ * @param stream  Index of the stream of blocks, i.e., intervals, points, or the clusters.
+ * @param block   Index of the block in the stream.
+ */
+static
+std::mt19937_64
+blockGenerator(
+  const size_t seed,
+  const size_t stream,
+  const size_t block
+)
+{
+  std::seed_seq sequence{static_cast<uint32_t>(seed), static_cast<uint32_t>(static_cast<uint64_t>(seed) >> 32),
+                         static_cast<uint32_t>(stream),
+                         static_cast<uint32_t>(block), static_cast<uint32_t>(static_cast<uint64_t>(block) >> 32)};
+  return std::mt19937_64(sequence);
+}
+
+/**
+ * @brief  Constructor for setting up the distributions of the workload.
+ *
+ * @tparam LimitType      Datatype of the limits of the intervals and the points.
+ * @param  lengths        Distribution of the lengths of the intervals (uniform, fixed, exponential).
+ *                        Uniform lengths are implied by drawing both the limits uniformly.
+ * @param  meanLength     Mean length of the intervals, for fixed and exponential lengths.
+ * @param  density        Expected number of intervals stabbed by a uniformly located point. If positive,
+ *                        the mean length is derived from it and the number of intervals.
+ * @param  locations      Distribution of the locations of the points (uniform, clustered, zipf).
+ * @param  numClusters    Number of clusters of clustered points.
+ * @param  zipfExponent   Exponent of the Zipfian distribution of the buckets of the points.
+ * @param  seed           Seed for the random number generators.
+ * @param  numThreads     Number of threads to be used for generating. 0 means one thread per hardware thread.
+ */
+template <typename LimitType>
+Workload<LimitType>::Workload(
+  const std::string& lengths,
+  const double meanLength,
+  const double density,
+  const std::string& locations,
+  const size_t numClusters,
+  const double zipfExponent,
+  const size_t seed,
+  const unsigned numThreads
+) : m_lengths(lengths),
+    m_meanLength(meanLength),
+    m_density(density),
+    m_locations(locations),
+    m_centers(),
+    m_spread(0.0),
+    m_zipfWeights(),
+    m_seed(seed),
+    m_numThreads(getNumThreads(numThreads))
+{
+  if ((m_lengths != "uniform") && (m_lengths != "fixed") && (m_lengths != "exponential")) {
+    throw std::runtime_error("Unsupported distribution of the lengths of the intervals.");
+  }
+  if ((m_lengths != "uniform") && !(m_meanLength > 0.0) && !(m_density > 0.0)) {
+    throw std::runtime_error("Either the mean length of the intervals or the stab density should be positive.");
+  }
+  const double low = static_cast<double>(lowestValue<LimitType>());
+  const double high = static_cast<double>(highestValue<LimitType>());
+  if (m_locations == "clustered") {
+    if (numClusters == 0) {
+      throw std::runtime_error("At least one cluster is needed for clustered points.");
+    }
+    std::mt19937_64 generator(blockGenerator(m_seed, 2, 0));
+    std::uniform_real_distribution<double> center(low, high);
+    for (size_t c = 0; c < numClusters; ++c) {
+      m_centers.push_back(center(generator));
+    }
+    m_spread = (high - low) / (numClusters * 64.0);
+  }
+  else if (m_locations == "zipf") {
+    // Weight of the bucket with the r-th rank.
+    for (size_t r = 1; r <= ZipfBuckets; ++r) {
+      m_zipfWeights.push_back(std::pow(static_cast<double>(r), -zipfExponent));
+    }
+  }
+  else if (m_locations != "uniform") {
+    throw std::runtime_error("Unsupported distribution of the locations of the points.");
+  }
+}
+
+/**
+ * @brief  Function for getting the mean length of the given number of intervals.
+ *
+ * @tparam LimitType  Datatype of the interval limits.
+ * @param  count      Number of intervals.
+ *
+ * For the target density d, n intervals of mean length L in a range of width W are stabbed
+ * by a uniformly located point n * L / W times on average. Therefore, L = d * W / n.
+ */
+template <typename LimitType>
+double
+Workload<LimitType>::meanLength(
+  const size_t count
+) const
+{
+  if (m_density > 0.0) {
+    const double width = static_cast<double>(highestValue<LimitType>()) - static_cast<double>(lowestValue<LimitType>());
+    return m_density * (width / std::max(count, static_cast<size_t>(1)));
+  }
+  return m_meanLength;
+}
+
+/**
+ * @brief  Function for generating a block of intervals.
+ *
+ * @tparam LimitType  Datatype of the interval limits.
+ * @param  block      Index of the block.
+ * @param  count      Number of intervals in the block.
+ * @param  length     Mean length of the intervals.
+ * @param  intervals  Vector to which the intervals are appended.
+ *
+ * Real intervals which cross zero are split in two, so that they can be programmed on the AP.
+ */
+template <typename LimitType>
+void
+Workload<LimitType>::generateIntervals(
+  const size_t block,
+  const size_t count,
+  const double length,
+  std::vector<std::pair<LimitType, LimitType> >& intervals
+) const
+{
+  std::mt19937_64 generator(blockGenerator(m_seed, 0, block));
+  std::exponential_distribution<double> exponential((length > 0.0) ? (1.0 / length) : 1.0);
+  const LimitType low = lowestValue<LimitType>(), high = highestValue<LimitType>();
+  intervals.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    std::pair<LimitType, LimitType> interval;
+    if (m_lengths == "uniform") {
+      LimitType x = uniformValue(low, high, generator);
+      LimitType y = uniformValue(low, high, generator);
+      interval = std::make_pair(std::min(x, y), std::max(x, y));
+    }
+    else {
+      interval = intervalOfLength<LimitType>((m_lengths == "fixed") ? length : exponential(generator), generator);
+    }
+    if (std::is_floating_point<LimitType>::value && std::signbit(interval.first) && !std::signbit(interval.second)) {
+      intervals.push_back(std::make_pair(interval.first, static_cast<LimitType>(std::copysign(0.0, interval.first))));
+      intervals.push_back(std::make_pair(static_cast<LimitType>(std::copysign(0.0, interval.second)), interval.second));
+    }
+    else {
+      intervals.push_back(interval);
+    }
+  }
+}
+
+/**
+ * @brief  Function for generating a block of points.
+ *
+ * @tparam LimitType  Datatype of the points.
+ * @param  block      Index of the block.
+ * @param  count      Number of points in the block.
+ * @param  points     Vector to which the points are appended.
+ *
+ * The buckets of Zipfian points are visited in a scrambled order of their ranks,
+ * so that the popular buckets are spread over the range.
+ */
+template <typename LimitType>
+void
+Workload<LimitType>::generatePoints(
+  const size_t block,
+  const size_t count,
+  std::vector<LimitType>& points
+) const
+{
+  std::mt19937_64 generator(blockGenerator(m_seed, 1, block));
+  const LimitType low = lowestValue<LimitType>(), high = highestValue<LimitType>();
+  const double width = static_cast<double>(high) - static_cast<double>(low);
+  points.reserve(count);
+  if (m_locations == "clustered") {
+    std::uniform_int_distribution<size_t> cluster(0, m_centers.size() - 1);
+    std::normal_distribution<double> offset(0.0, m_spread);
+    for (size_t p = 0; p < count; ++p) {
+      points.push_back(clampedValue<LimitType>(m_centers[cluster(generator)] + offset(generator)));
+    }
+  }
+  else if (m_locations == "zipf") {
+    std::discrete_distribution<size_t> rank(m_zipfWeights.begin(), m_zipfWeights.end());
+    std::uniform_real_distribution<double> position(0.0, 1.0);
+    for (size_t p = 0; p < count; ++p) {
+      // Multiplying by an odd number permutes the buckets, since their number is a power of two.
+      const size_t bucket = (rank(generator) * 2654435761u) % ZipfBuckets;
+      points.push_back(clampedValue<LimitType>(static_cast<double>(low) + ((bucket + position(generator)) * (width / ZipfBuckets))));
+    }
+  }
+  else {
+    for (size_t p = 0; p < count; ++p) {
+      points.push_back(uniformValue(low, high, generator));
+    }
+  }
+}
+
+/**
+ * @brief  Function for generating the given number of records, with the blocks generated on many threads.
+ *
+ * @tparam LimitType   Datatype of the limits of the intervals and the points.
+ * @tparam RecordType  Type of the records, i.e., intervals or points.
+ * @tparam Generate    Type of the function which generates a block.
+ * @param  count       Number of records to be generated.
+ * @param  generate    Function called as generate(block, count, records) for appending a block to records.
+ */
+template <typename LimitType>
+template <typename RecordType, typename Generate>
+std::vector<RecordType>
+Workload<LimitType>::generate(
+  const size_t count,
+  Generate generate
+) const
+{
+  const size_t numBlocks = (count + BlockSize - 1) / BlockSize;
+  std::vector<std::vector<RecordType> > blocks(numBlocks);
+  parallelFor(m_numThreads, numBlocks,
+              [&](const unsigned, const size_t first, const size_t last)
+              {
+                for (size_t b = first; b < last; ++b) {
+                  generate(b, std::min(BlockSize, count - (b * BlockSize)), blocks[b]);
+                }
+              });
+  if (blocks.size() == 1) {
+    return std::move(blocks.front());
+  }
+  size_t total = 0;
+  for (const std::vector<RecordType>& block : blocks) {
+    total += block.size();
+  }
+  std::vector<RecordType> records;
+  records.reserve(total);
+  for (std::vector<RecordType>& block : blocks) {
+    records.insert(records.end(), block.begin(), block.end());
+    std::vector<RecordType>().swap(block);
+  }
+  return records;
+}
+
+/**
+ * @brief  Function for generating the given number of records and writing them to a binary file.
+ *
+ * @tparam LimitType   Datatype of the limits of the intervals and the points.
+ * @tparam RecordType  Type of the records, i.e., intervals or points.
+ * @tparam Generate    Type of the function which generates a block.
+ * @param  fileName    Name of the binary file to be written.
+ * @param  arity       Number of values in every record.
+ * @param  count       Number of records to be generated.
+ * @param  generate    Function called as generate(block, count, records) for appending a block to records.
+ *
+ * Only a few blocks per thread are held in memory at a time, so that workloads larger than the memory
+ * can be written. The records are the same as the ones generated in memory.
+ */
+template <typename LimitType>
+template <typename RecordType, typename Generate>
+void
+Workload<LimitType>::save(
+  const std::string& fileName,
+  const uint32_t arity,
+  const size_t count,
+  Generate generate
+) const
+{
+  std::ofstream file(fileName, std::ios::binary);
+  // The number of records is written again at the end, since intervals may be split.
+  BinaryFile::writeHeader(file, binaryType<LimitType>(), arity, count);
+  const size_t numBlocks = (count + BlockSize - 1) / BlockSize;
+  const size_t perWrite = m_numThreads * BlocksPerWrite;
+  std::vector<std::vector<RecordType> > blocks(perWrite);
+  size_t total = 0;
+  for (size_t firstBlock = 0; firstBlock < numBlocks; firstBlock += perWrite) {
+    const size_t numWritten = std::min(perWrite, numBlocks - firstBlock);
+    parallelFor(m_numThreads, numWritten,
+                [&](const unsigned, const size_t first, const size_t last)
+                {
+                  for (size_t w = first; w < last; ++w) {
+                    const size_t b = firstBlock + w;
+                    blocks[w].clear();
+                    generate(b, std::min(BlockSize, count - (b * BlockSize)), blocks[w]);
+                  }
+                });
+    for (size_t w = 0; w < numWritten; ++w) {
+      file.write(reinterpret_cast<const char*>(blocks[w].data()), blocks[w].size() * sizeof(RecordType));
+      total += blocks[w].size();
+    }
+  }
+  if (total != count) {
+    file.seekp(0);
+    BinaryFile::writeHeader(file, binaryType<LimitType>(), arity, total);
+  }
+  if (!file) {
+    throw std::runtime_error("Couldn't write the binary file " + fileName + ".");
+  }
+}
+
+/**
+ * @brief  Function for generating intervals.
+ *
+ * @tparam LimitType  Datatype of the interval limits.
+ * @param  count      Number of intervals to be generated.
+ *
+ * @return  The generated intervals, which are more than the given number if any real intervals were split.
+ */
+template <typename LimitType>
+Intervals<LimitType>
+Workload<LimitType>::intervals(
+  const size_t count
+) const
+{
+  ProfiledPhase generating("generate_intervals", count * 2 * sizeof(LimitType));
+  const double length = meanLength(count);
+  return Intervals<LimitType>(generate<std::pair<LimitType, LimitType> >(count,
+                                [this, length](const size_t block, const size_t n, std::vector<std::pair<LimitType, LimitType> >& intervals)
+                                { generateIntervals(block, n, length, intervals); }));
+}
+
+/**
+ * @brief  Function for generating points.
+ *
+ * @tparam LimitType  Datatype of the points.
+ * @param  count      Number of points to be generated.
+ */
+template <typename LimitType>
+Points<LimitType>
+Workload<LimitType>::points(
+  const size_t count
+) const
+{
+  ProfiledPhase generating("generate_points", count * sizeof(LimitType));
+  return Points<LimitType>(generate<LimitType>(count,
+                             [this](const size_t block, const size_t n, std::vector<LimitType>& points)
+                             { generatePoints(block, n, points); }));
+}
+
+/**
+ * @brief  Function for generating intervals directly to a binary file.
+ *
+ * @tparam LimitType  Datatype of the interval limits.
+ * @param  fileName   Name of the binary file to be written.
+ * @param  count      Number of intervals to be generated.
+ */
+template <typename LimitType>
+void
+Workload<LimitType>::saveIntervals(
+  const std::string& fileName,
+  const size_t count
+) const
+{
+  ProfiledPhase generating("generate_intervals", count * 2 * sizeof(LimitType));
+  const double length = meanLength(count);
+  save<std::pair<LimitType, LimitType> >(fileName, 2, count,
+    [this, length](const size_t block, const size_t n, std::vector<std::pair<LimitType, LimitType> >& intervals)
+    { generateIntervals(block, n, length, intervals); });
+}
+
+/**
+ * @brief  Function for generating points directly to a binary file.
+ *
+ * @tparam LimitType  Datatype of the points.
+ * @param  fileName   Name of the binary file to be written.
+ * @param  count      Number of points to be generated.
+ */
+template <typename LimitType>
+void
+Workload<LimitType>::savePoints(
+  const std::string& fileName,
+  const size_t count
+) const
+{
+  ProfiledPhase generating("generate_points", count * sizeof(LimitType));
+  save<LimitType>(fileName, 1, count,
+    [this](const size_t block, const size_t n, std::vector<LimitType>& points)
+    { generatePoints(block, n, points); });
+}
+
+/**
+ * @brief  Default destructor.
+ *
+ * @tparam LimitType  Datatype of the limits of the intervals and the points.
+ */
+template <typename LimitType>
+Workload<LimitType>::~Workload(
+)
+{
+}
+
+// Explicit class instantiation.
+template class Workload<uint32_t>;
+template class Workload<int32_t>;
+template class Workload<uint64_t>;
+template class Workload<int64_t>;
+template class Workload<float>;
+template class Workload<double>;
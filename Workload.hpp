@@ -0,0 +1,104 @@
+/**
+ * @file Workload.hpp
+ * @brief Declaration of Workload functions.
+ * @author Ankit Srivastava <asrivast@gatech.edu>
+ *
+ * Copyright 2018 Georgia Institute of Technology
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef WORKLOAD_HPP_
+#define WORKLOAD_HPP_
+
+#include "Intervals.hpp"
+#include "Points.hpp"
+
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+/**
+ * @brief  Class for generating random intervals and points with configurable distributions.
+ *
+ * @tparam LimitType  Datatype of the limits of the intervals and the points.
+ *
+ * The values are drawn from the whole range of integer datatypes, and from [-max/2, max/2] for real datatypes.
+ * The lengths of the intervals are either implied by uniformly drawn limits, or fixed, or exponentially distributed
+ * with the given mean. The mean length can also be derived from a target stab density, i.e., the expected number of
+ * intervals stabbed by a uniformly located point. The points are located uniformly, around a few normally
+ * distributed clusters, or in buckets of the range whose popularity follows Zipf's law.
+ *
+ * The records are generated in blocks of fixed size, every block with its own random number generator seeded from
+ * the seed and the index of the block. Therefore, the blocks are generated on many threads, and the generated
+ * records don't depend on the number of threads.
+ */
+template <typename LimitType>
+class Workload {
+public:
+  Workload(const std::string&, const double, const double, const std::string&, const size_t, const double, const size_t, const unsigned);
+
+  Intervals<LimitType>
+  intervals(const size_t) const;
+
+  Points<LimitType>
+  points(const size_t) const;
+
+  void
+  saveIntervals(const std::string&, const size_t) const;
+
+  void
+  savePoints(const std::string&, const size_t) const;
+
+  ~Workload();
+
+private:
+  // Number of records generated with one random number generator.
+  static const size_t BlockSize = 1 << 16;
+  // Number of blocks generated on every thread before they are written to a file.
+  static const size_t BlocksPerWrite = 16;
+  // Number of buckets of the range for Zipfian locations.
+  static const size_t ZipfBuckets = 1 << 12;
+
+private:
+  double
+  meanLength(const size_t) const;
+
+  void
+  generateIntervals(const size_t, const size_t, const double, std::vector<std::pair<LimitType, LimitType> >&) const;
+
+  void
+  generatePoints(const size_t, const size_t, std::vector<LimitType>&) const;
+
+  template <typename RecordType, typename Generate>
+  std::vector<RecordType>
+  generate(const size_t, Generate) const;
+
+  template <typename RecordType, typename Generate>
+  void
+  save(const std::string&, const uint32_t, const size_t, Generate) const;
+
+private:
+  std::string m_lengths;
+  double m_meanLength;
+  double m_density;
+  std::string m_locations;
+  std::vector<double> m_centers;
+  double m_spread;
+  std::vector<double> m_zipfWeights;
+  size_t m_seed;
+  unsigned m_numThreads;
+}; // class Workload
+
+#endif // WORKLOAD_HPP_
@@ -0,0 +1,508 @@
+/**
+ * @file bench.cpp
+ * @brief File containing functions that benchmark the stabbing engines on synthetic workloads.
+ * @author Ankit Srivastava <asrivast@gatech.edu>
+ *
+ * Copyright 2018 Georgia Institute of Technology
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "Intervals.hpp"
+#include "Points.hpp"
+#include "StabbedIntervals.hpp"
+#include "StabbingSession.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <type_traits>
+
+#include <boost/program_options.hpp>
+
+namespace po = boost::program_options;
+
+
+/**
+ * @brief  Options of the benchmark.
+ */
+struct BenchOptions {
+  std::vector<std::string> engines;
+  std::vector<std::string> shapes;
+  std::vector<std::string> types;
+  std::vector<size_t> numIntervals;
+  std::vector<size_t> numPoints;
+  std::string mode;
+  std::vector<std::string> deviceNames;
+  std::string macrosDir;
+  std::string outputFile;
+  size_t numBatches;
+  size_t numWarmups;
+  size_t seed;
+  unsigned numThreads;
+};
+
+// Number of cells in the domain from which the limits and the points are drawn.
+static const int64_t DomainSize = static_cast<int64_t>(1) << 30;
+
+/**
+ * @brief  Function for getting the first cell of the domain of the given datatype.
+ *
+ * @tparam DataType  Datatype of the limits and the points.
+ *
+ * The domain of signed datatypes is centered at zero, so that the intervals cross zero.
+ */
+template <typename DataType>
+static
+int64_t
+domainStart(
+)
+{
+  return std::is_signed<DataType>::value ? -(DomainSize / 2) : 0;
+}
+
+/**
+ * @brief  Function for drawing a value of the given datatype from a cell of the domain.
+ *
+ * @tparam DataType  Datatype of the limits and the points.
+ * @param cell       Cell from which the value is drawn.
+ * @param generator  Random number generator.
+ *
+ * The cells split the whole range of the datatype evenly, so that the shapes of the workloads are the same
+ * for all the datatypes, while the limits of wider datatypes differ in all their bytes.
+ */
+template <typename DataType>
+static
+DataType
+cellValue(
+  const int64_t cell,
+  std::mt19937_64& generator
+)
+{
+  const uint64_t step = (static_cast<uint64_t>(std::numeric_limits<typename std::make_unsigned<DataType>::type>::max()) / DomainSize) + 1;
+  std::uniform_int_distribution<uint64_t> offset(0, step - 1);
+  if (std::is_signed<DataType>::value) {
+    return static_cast<DataType>((cell * static_cast<int64_t>(step)) + static_cast<int64_t>(offset(generator)));
+  }
+  return static_cast<DataType>((static_cast<uint64_t>(cell) * step) + offset(generator));
+}
+
+/**
+ * @brief  Function for drawing an interval of the given datatype from the given cells of the domain.
+ *
+ * @tparam DataType  Datatype of the interval limits.
+ * @param first      Cell of the lower limit.
+ * @param last       Cell of the upper limit, which isn't before the first cell.
+ * @param generator  Random number generator.
+ */
+template <typename DataType>
+static
+std::pair<DataType, DataType>
+cellInterval(
+  const int64_t first,
+  const int64_t last,
+  std::mt19937_64& generator
+)
+{
+  DataType x = cellValue<DataType>(first, generator), y = cellValue<DataType>(last, generator);
+  return std::make_pair(std::min(x, y), std::max(x, y));
+}
+
+/**
+ * @brief  Function for generating intervals of the given shape.
+ *
+ * @tparam DataType  Datatype of the interval limits.
+ * @param shape      Shape of the intervals (uniform, nested, disjoint, genomic).
+ * @param count      Number of intervals to be generated.
+ * @param generator  Random number generator.
+ *
+ * Uniform intervals have both the limits drawn uniformly from the domain. Nested intervals are centered
+ * around the middle of the domain with uniformly drawn lengths, so that most of them contain each other.
+ * Disjoint intervals are drawn from their own slices of the domain. Genomic intervals are short, with
+ * log-normally distributed lengths, and are clustered around a few hotspots, like reads mapped to a genome.
+ */
+template <typename DataType>
+static
+std::vector<std::pair<DataType, DataType> >
+generateIntervals(
+  const std::string& shape,
+  const size_t count,
+  std::mt19937_64& generator
+)
+{
+  const int64_t start = domainStart<DataType>();
+  const int64_t last = start + DomainSize - 1;
+  std::uniform_int_distribution<int64_t> limit(start, last);
+  std::vector<std::pair<DataType, DataType> > intervals;
+  intervals.reserve(count);
+  if (shape == "uniform") {
+    for (size_t i = 0; i < count; ++i) {
+      int64_t x = limit(generator), y = limit(generator);
+      intervals.push_back(cellInterval<DataType>(std::min(x, y), std::max(x, y), generator));
+    }
+  }
+  else if (shape == "nested") {
+    const int64_t middle = start + (DomainSize / 2);
+    std::uniform_int_distribution<int64_t> offset(-(DomainSize >> 10), DomainSize >> 10);
+    std::uniform_int_distribution<int64_t> halfLength(0, (DomainSize / 2) - (DomainSize >> 10) - 1);
+    for (size_t i = 0; i < count; ++i) {
+      int64_t center = middle + offset(generator), half = halfLength(generator);
+      intervals.push_back(cellInterval<DataType>(center - half, center + half, generator));
+    }
+  }
+  else if (shape == "disjoint") {
+    const int64_t slice = std::max(DomainSize / static_cast<int64_t>(std::max(count, static_cast<size_t>(1))), static_cast<int64_t>(1));
+    std::uniform_int_distribution<int64_t> position(0, slice - 1);
+    for (size_t i = 0; i < count; ++i) {
+      int64_t first = start + ((static_cast<int64_t>(i) * slice) % DomainSize);
+      int64_t x = first + position(generator), y = first + position(generator);
+      intervals.push_back(cellInterval<DataType>(std::min(x, y), std::max(x, y), generator));
+    }
+    std::shuffle(intervals.begin(), intervals.end(), generator);
+  }
+  else if (shape == "genomic") {
+    const size_t numHotspots = 16;
+    std::vector<int64_t> hotspots(numHotspots);
+    for (int64_t& hotspot : hotspots) {
+      hotspot = limit(generator);
+    }
+    std::uniform_int_distribution<size_t> pick(0, numHotspots - 1);
+    std::normal_distribution<double> spread(0.0, static_cast<double>(DomainSize >> 8));
+    std::lognormal_distribution<double> length(std::log(1000.0), 1.0);
+    for (size_t i = 0; i < count; ++i) {
+      double x = static_cast<double>(hotspots[pick(generator)]) + spread(generator);
+      int64_t lower = std::min(std::max(static_cast<int64_t>(x), start), last);
+      int64_t upper = std::min(lower + static_cast<int64_t>(length(generator)), last);
+      intervals.push_back(cellInterval<DataType>(lower, upper, generator));
+    }
+  }
+  else {
+    throw std::runtime_error("Unsupported shape " + shape + ".");
+  }
+  return intervals;
+}
+
+/**
+ * @brief  Function for generating points drawn uniformly from the domain.
+ *
+ * @tparam DataType  Datatype of the points.
+ * @param count      Number of points to be generated.
+ * @param generator  Random number generator.
+ */
+template <typename DataType>
+static
+std::vector<DataType>
+generatePoints(
+  const size_t count,
+  std::mt19937_64& generator
+)
+{
+  const int64_t start = domainStart<DataType>();
+  std::uniform_int_distribution<int64_t> coordinate(start, start + DomainSize - 1);
+  std::vector<DataType> points;
+  points.reserve(count);
+  for (size_t p = 0; p < count; ++p) {
+    points.push_back(cellValue<DataType>(coordinate(generator), generator));
+  }
+  return points;
+}
+
+/**
+ * @brief  Function for getting a percentile of the given latencies, using the nearest rank.
+ *
+ * @param latencies  Latencies, which are sorted in place.
+ * @param fraction   Fraction of the latencies at or below the percentile.
+ */
+static
+double
+percentile(
+  std::vector<double>& latencies,
+  const double fraction
+)
+{
+  if (latencies.empty()) {
+    return 0.0;
+  }
+  std::sort(latencies.begin(), latencies.end());
+  size_t rank = static_cast<size_t>(std::ceil(fraction * latencies.size()));
+  return latencies[std::max(rank, static_cast<size_t>(1)) - 1];
+}
+
+/**
+ * @brief  Function for resetting the peak resident set size of the process to its current resident set size.
+ *
+ * @return  true if the peak was reset, which is supported by Linux 4.0 and later.
+ */
+static
+bool
+resetPeakResidentSize(
+)
+{
+  std::ofstream clearRefs("/proc/self/clear_refs");
+  clearRefs << "5" << std::flush;
+  return static_cast<bool>(clearRefs);
+}
+
+/**
+ * @brief  Function for reading a size from the status of the process, in kilobytes.
+ *
+ * @param field  Name of the field in /proc/self/status, e.g., VmRSS or VmHWM.
+ *
+ * @return  The size, or -1 if it couldn't be read.
+ */
+static
+long
+statusKilobytes(
+  const std::string& field
+)
+{
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  while (std::getline(status, line)) {
+    if (line.compare(0, field.size() + 1, field + ":") == 0) {
+      return std::stol(line.substr(field.size() + 1));
+    }
+  }
+  return -1;
+}
+
+/**
+ * @brief  Function for getting the seconds elapsed since the given time.
+ *
+ * @param start  Time at which the measurement started.
+ */
+static
+double
+secondsSince(
+  const std::chrono::steady_clock::time_point& start
+)
+{
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * @brief  Function for benchmarking one engine on one workload and writing the results as a JSON object.
+ *
+ * @tparam DataType  Datatype of the interval limits and the points.
+ * @param options    Options of the benchmark.
+ * @param intervals  Intervals to be stabbed.
+ * @param batches    Batches of points, the first few of which are only used for warming up.
+ * @param engine     Name of the engine to be benchmarked.
+ * @param results    Stream to which the measurements are written, as fields of a JSON object.
+ *
+ * The setup time is the time taken for creating a session, i.e., for programming and loading the automata
+ * or for building the indices. The one-shot time is the time taken by Intervals::stab for the first batch,
+ * which creates its own session. Throughput and latencies are measured over the batches queried in the session.
+ */
+template <typename DataType>
+static
+void
+benchmarkEngine(
+  const BenchOptions& options,
+  const Intervals<DataType>& intervals,
+  const std::vector<Points<DataType> >& batches,
+  const std::string& engine,
+  std::ostream& results
+)
+{
+  const size_t maxChunkSize = std::numeric_limits<size_t>::max();
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  intervals.stab(batches.front(), engine, options.deviceNames, "auto", options.macrosDir, "", "", 0, maxChunkSize, options.numThreads);
+  double oneShot = secondsSince(start);
+
+  start = std::chrono::steady_clock::now();
+  StabbingSession<DataType> session(intervals, engine, options.deviceNames, "auto", options.macrosDir, "", "", 0, 0, maxChunkSize, options.numThreads);
+  double setup = secondsSince(start);
+
+  std::vector<double> latencies;
+  size_t numQueried = 0, numStabbed = 0;
+  double total = 0.0;
+  for (size_t b = 0; b < batches.size(); ++b) {
+    start = std::chrono::steady_clock::now();
+    size_t stabbed = 0;
+    if (options.mode == "count") {
+      std::vector<size_t> counts(session.count(batches[b]));
+      for (const size_t& count : counts) {
+        stabbed += count;
+      }
+    }
+    else {
+      stabbed = session.query(batches[b]).size();
+    }
+    double latency = secondsSince(start);
+    if (b < options.numWarmups) {
+      continue;
+    }
+    latencies.push_back(latency);
+    total += latency;
+    numQueried += batches[b].count();
+    numStabbed += stabbed;
+  }
+  results << ",\"one_shot_seconds\":" << oneShot
+         << ",\"setup_seconds\":" << setup
+         << ",\"points_per_second\":" << ((total > 0.0) ? (numQueried / total) : 0.0)
+         << ",\"p50_batch_seconds\":" << percentile(latencies, 0.5)
+         << ",\"p99_batch_seconds\":" << percentile(latencies, 0.99)
+         << ",\"stabbed\":" << numStabbed
+         << ",\"output_bytes\":" << ((options.mode == "count") ? (numQueried * sizeof(size_t)) : (numStabbed * sizeof(size_t)));
+}
+
+/**
+ * @brief  Function for benchmarking all the engines on all the workloads of the given datatype.
+ *
+ * @tparam DataType  Datatype of the interval limits and the points.
+ * @param options    Options of the benchmark.
+ * @param type       Name of the datatype, as written in the results.
+ * @param output     Stream to which the results are written, one JSON object per line.
+ */
+template <typename DataType>
+static
+void
+benchmarkType(
+  const BenchOptions& options,
+  const std::string& type,
+  std::ostream& output
+)
+{
+  for (const std::string& shape : options.shapes) {
+    for (const size_t& numIntervals : options.numIntervals) {
+      std::mt19937_64 generator(options.seed);
+      Intervals<DataType> intervals(generateIntervals<DataType>(shape, numIntervals, generator));
+      for (const size_t& numPoints : options.numPoints) {
+        std::vector<Points<DataType> > batches;
+        for (size_t b = 0; b < (options.numWarmups + options.numBatches); ++b) {
+          batches.push_back(Points<DataType>(generatePoints<DataType>(numPoints, generator)));
+        }
+        for (const std::string& engine : options.engines) {
+          std::stringstream record;
+          record << "{\"type\":\"" << type << "\",\"shape\":\"" << shape << "\",\"engine\":\"" << engine
+                 << "\",\"mode\":\"" << options.mode << "\",\"intervals\":" << numIntervals
+                 << ",\"points_per_batch\":" << numPoints << ",\"batches\":" << options.numBatches
+                 << ",\"threads\":" << options.numThreads;
+          // Engines which can't be run, e.g., for want of the macros, are recorded with the error.
+          std::stringstream results;
+          // The peak is reset before every engine, so that it only covers the engine and the workload.
+          const bool reset = resetPeakResidentSize();
+          const long baseline = statusKilobytes("VmRSS");
+          try {
+            benchmarkEngine(options, intervals, batches, engine, results);
+            record << results.str();
+          }
+          catch (std::runtime_error& re) {
+            std::string error(re.what());
+            std::replace(error.begin(), error.end(), '"', '\'');
+            record << ",\"error\":\"" << error << "\"";
+          }
+          if (reset) {
+            record << ",\"baseline_rss_kb\":" << baseline << ",\"peak_rss_kb\":" << statusKilobytes("VmHWM") << "}";
+          }
+          else {
+            record << ",\"baseline_rss_kb\":null,\"peak_rss_kb\":null}";
+          }
+          output << record.str() << std::endl;
+          std::cerr << record.str() << std::endl;
+        }
+      }
+    }
+  }
+}
+
+/**
+ * @brief  Main function for parsing the arguments and benchmarking every requested datatype.
+ *
+ * @param argc  Number of provided arguments.
+ * @param argv  A char array containing arguments.
+ *
+ * @return  0 if the execution completed smoothly. A non-zero code otherwise.
+ */
+int
+main(
+  int argc,
+  char** argv
+)
+{
+  BenchOptions options;
+  po::options_description description("Benchmarks the stabbing engines on synthetic workloads");
+  description.add_options()
+    ("help,h", "Print this message.")
+    ("engines,e", po::value<std::vector<std::string> >(&options.engines)->multitoken()->default_value({"ap", "tree", "sweep"}, "ap tree sweep"), "Engines to be benchmarked.")
+    ("shapes", po::value<std::vector<std::string> >(&options.shapes)->multitoken()->default_value({"uniform", "nested", "disjoint", "genomic"}, "uniform nested disjoint genomic"), "Shapes of the intervals (uniform, nested, disjoint, genomic).")
+    ("types", po::value<std::vector<std::string> >(&options.types)->multitoken()->default_value({"uint32", "int32", "uint64", "int64"}, "uint32 int32 uint64 int64"), "Datatypes of the intervals and the points (uint32, int32, uint64, int64).")
+    ("intervals,I", po::value<std::vector<size_t> >(&options.numIntervals)->multitoken()->default_value({1000, 10000}, "1000 10000"), "Numbers of intervals.")
+    ("points,P", po::value<std::vector<size_t> >(&options.numPoints)->multitoken()->default_value({1000}, "1000"), "Numbers of points in every batch.")
+    ("mode", po::value<std::string>(&options.mode)->default_value("list"), "Result of stabbing for every point (list, count).")
+    ("device,d", po::value<std::vector<std::string> >(&options.deviceNames)->multitoken(), "Names of the AP devices to be used by the AP engine (simulator for simulating a device on the CPU).")
+    ("macros,m", po::value<std::string>(&options.macrosDir)->default_value("./comparators"), "Directory which contains all the comparator macros.")
+    ("output,o", po::value<std::string>(&options.outputFile)->default_value("bench.jsonl"), "Name of the file to which the results are written, one JSON object per line.")
+    ("batches", po::value<size_t>(&options.numBatches)->default_value(5), "Number of measured batches of points.")
+    ("warmups", po::value<size_t>(&options.numWarmups)->default_value(1), "Number of batches of points queried before measuring.")
+    ("seed,s", po::value<size_t>(&options.seed)->default_value(0), "Seed for random number generator.")
+    ("threads,t", po::value<unsigned>(&options.numThreads)->default_value(1), "Number of threads to be used on the host (0 for all the hardware threads).")
+    ;
+  try {
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, description), vm);
+    po::notify(vm);
+    if (vm.count("help") > 0) {
+      std::stringstream ss;
+      ss << description;
+      throw po::error(ss.str());
+    }
+    if ((options.mode != "list") && (options.mode != "count")) {
+      throw po::error("Unsupported mode.");
+    }
+    if (options.numBatches == 0) {
+      throw po::error("At least one batch should be measured.");
+    }
+  }
+  catch (po::error& pe) {
+    std::cerr << pe.what() << std::endl;
+    return 1;
+  }
+
+  try {
+    std::ofstream output(options.outputFile);
+    if (!output) {
+      throw std::runtime_error("Couldn't open the file " + options.outputFile + ".");
+    }
+    for (const std::string& type : options.types) {
+      if (type == "uint32") {
+        benchmarkType<uint32_t>(options, type, output);
+      }
+      else if (type == "int32") {
+        benchmarkType<int32_t>(options, type, output);
+      }
+      else if (type == "uint64") {
+        benchmarkType<uint64_t>(options, type, output);
+      }
+      else if (type == "int64") {
+        benchmarkType<int64_t>(options, type, output);
+      }
+      else {
+        throw std::runtime_error("Unsupported type " + type + ".");
+      }
+    }
+  }
+  catch (std::runtime_error& re) {
+    std::cerr << re.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -17,69 +17,500 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include "BoxSession.hpp"
+#include "Boxes.hpp"
 #include "Intervals.hpp"
 #include "Points.hpp"
+#include "Profiler.hpp"
 #include "ProgramOptions.hpp"
+#include "ResultWriter.hpp"
+#include "StabbedIntervals.hpp"
+#include "StabbingSession.hpp"
+#include "TextParser.hpp"
+#include "Workload.hpp"
 
+#include <algorithm>
+#include <array>
+#include <fstream>
 #include <iostream>
 
 
 /**
- * @brief  Function for printing the intervals stabbed by the given points.
+ * @brief  Functions for printing a query, which is either a point, an interval, or a D-dimensional point.
+ */
+template <typename DataType>
+static
+void
+printQuery(
+  ResultWriter& out,
+  const DataType& point
+)
+{
+  out << point;
+}
+
+template <typename DataType>
+static
+void
+printQuery(
+  ResultWriter& out,
+  const std::pair<DataType, DataType>& interval
+)
+{
+  out << '[' << interval.first << ',' << interval.second << ']';
+}
+
+template <typename DataType, size_t D>
+static
+void
+printQuery(
+  ResultWriter& out,
+  const std::array<DataType, D>& point
+)
+{
+  out << '(' << point[0];
+  for (size_t k = 1; k < D; ++k) {
+    out << ',' << point[k];
+  }
+  out << ')';
+}
+
+/**
+ * @brief  Function for printing the intervals found for the given queries.
+ *
+ * @tparam DataType  Datatype of the interval limits and the points.
+ * @tparam Queries   Type of the queries, either points or intervals.
+ * @param out        Writer to which the results are printed.
+ * @param session    Session in which the intervals were queried.
+ * @param queries    Points which were used for stabbing, or intervals which were checked for overlaps.
+ * @param found      Indices of the intervals found for every query.
+ * @param header     Header of the printed table.
+ * @param none       Message printed if no intervals were found.
+ */
+template <typename DataType, typename Queries>
+static
+void
+printStabs(
+  ResultWriter& out,
+  const StabbingSession<DataType>& session,
+  const Queries& queries,
+  const StabbedIntervals& found,
+  const std::string& header,
+  const std::string& none
+)
+{
+  ProfiledPhase print("print");
+  size_t written = out.bytes();
+  size_t maxFound = 0;
+  if (out.format() != "text") {
+    for (size_t q = 0; q < queries.count(); ++q) {
+      for (const size_t* i = found.begin(q); i != found.end(q); ++i) {
+        out.writeIndices(out.firstQuery() + q, *i);
+      }
+      maxFound = std::max(maxFound, found.size(q));
+    }
+  }
+  else if (found.empty()) {
+    out << none << '\n';
+  }
+  else {
+    out << header << '\n';
+    for (size_t q = 0; q < queries.count(); ++q) {
+      printQuery(out, queries.get(q));
+      for (const size_t* i = found.begin(q); i != found.end(q); ++i) {
+        if (out.indicesOnly()) {
+          out << '\t' << *i;
+        }
+        else {
+          const std::pair<DataType, DataType>& interval = session.get(*i);
+          out << "\t[" << interval.first << ',' << interval.second << ']';
+        }
+      }
+      out << '\n';
+      maxFound = std::max(maxFound, found.size(q));
+    }
+  }
+  out.endBatch(queries.count());
+  Profiler::setMaximum("max_stabs_per_query", maxFound);
+  print.addBytes(out.bytes() - written);
+}
+
+/**
+ * @brief  Function for printing the number of intervals found for the given queries.
+ *
+ * @tparam Queries  Type of the queries, either points or intervals.
+ * @param out       Writer to which the results are printed.
+ * @param queries   Points which were used for stabbing, or intervals which were checked for overlaps.
+ * @param counts    Number of intervals found for every query.
+ * @param header    Header of the printed table.
+ */
+template <typename Queries>
+static
+void
+printCounts(
+  ResultWriter& out,
+  const Queries& queries,
+  const std::vector<size_t>& counts,
+  const std::string& header
+)
+{
+  ProfiledPhase print("print");
+  size_t written = out.bytes();
+  if (out.format() != "text") {
+    for (size_t q = 0; q < queries.count(); ++q) {
+      out.writeIndices(out.firstQuery() + q, counts[q]);
+    }
+  }
+  else {
+    out << header << '\n';
+    for (size_t q = 0; q < queries.count(); ++q) {
+      printQuery(out, queries.get(q));
+      out << '\t' << counts[q] << '\n';
+    }
+  }
+  out.endBatch(queries.count());
+  if (Profiler::enabled() && !counts.empty()) {
+    Profiler::setMaximum("max_stabs_per_query", *std::max_element(counts.begin(), counts.end()));
+  }
+  print.addBytes(out.bytes() - written);
+}
+
+/**
+ * @brief  Function for printing whether any intervals were found for the given queries.
+ *
+ * @tparam Queries  Type of the queries, either points or intervals.
+ * @param out       Writer to which the results are printed.
+ * @param queries   Points which were used for stabbing, or intervals which were checked for overlaps.
+ * @param found     A bit for every query, which is set if any interval was found for the query.
+ * @param header    Header of the printed table.
+ */
+template <typename Queries>
+static
+void
+printAny(
+  ResultWriter& out,
+  const Queries& queries,
+  const std::vector<bool>& found,
+  const std::string& header
+)
+{
+  ProfiledPhase print("print");
+  size_t written = out.bytes();
+  if (out.format() != "text") {
+    for (size_t q = 0; q < queries.count(); ++q) {
+      out.writeIndices(out.firstQuery() + q, found[q] ? 1 : 0);
+    }
+  }
+  else {
+    out << header << '\n';
+    for (size_t q = 0; q < queries.count(); ++q) {
+      printQuery(out, queries.get(q));
+      out << (found[q] ? "\t1\n" : "\t0\n");
+    }
+  }
+  out.endBatch(queries.count());
+  print.addBytes(out.bytes() - written);
+}
+
+/**
+ * @brief  Function for stabbing the intervals with a batch of points and printing the results.
  *
  * @tparam DataType  Datatype of the interval limits and the points.
+ * @param out        Writer to which the results are printed.
+ * @param session    Session prepared for stabbing the intervals.
+ * @param points     Points to be used for stabbing.
+ * @param mode       Result to be printed for every point (list, count, any).
+ */
+template <typename DataType>
+static
+void
+stabBatch(
+  ResultWriter& out,
+  StabbingSession<DataType>& session,
+  const Points<DataType>& points,
+  const std::string& mode
+)
+{
+  if (mode == "count") {
+    printCounts(out, points, session.count(points), "Point\tStabbed Intervals");
+  }
+  else if (mode == "any") {
+    printAny(out, points, session.any(points), "Point\tStabbing");
+  }
+  else {
+    printStabs(out, session, points, session.query(points), "Point\tStabbed Intervals", "None of the points were found to be stabbing any intervals.");
+  }
+}
+
+/**
+ * @brief  Function for checking the intervals for overlaps with a batch of query intervals and printing the results.
+ *
+ * @tparam DataType  Datatype of the interval limits.
+ * @param out        Writer to which the results are printed.
+ * @param session    Session prepared for querying the intervals.
+ * @param queries    Query intervals to be checked.
+ * @param mode       Result to be printed for every query (list, count, any).
+ */
+template <typename DataType>
+static
+void
+overlapBatch(
+  ResultWriter& out,
+  StabbingSession<DataType>& session,
+  const Intervals<DataType>& queries,
+  const std::string& mode
+)
+{
+  if (mode == "count") {
+    printCounts(out, queries, session.countOverlaps(queries), "Query\tOverlapping Intervals");
+  }
+  else if (mode == "any") {
+    printAny(out, queries, session.anyOverlaps(queries), "Query\tOverlapping");
+  }
+  else {
+    printStabs(out, session, queries, session.overlap(queries), "Query\tOverlapping Intervals", "None of the queries were found to be overlapping any intervals.");
+  }
+}
+
+/**
+ * @brief  Function for inserting and erasing intervals in a session, as listed in a file.
+ *
+ * @tparam DataType    Datatype of the interval limits and the points.
+ * @param session      Session in which the intervals are updated.
+ * @param updatesFile  Name of the file with one update per line, either "+ lower upper" for inserting
+ *                     an interval or "- index" for erasing the interval with the given index.
+ *
+ * Inserted intervals are indexed after all the existing intervals, in the order of insertion.
+ */
+template <typename DataType>
+static
+void
+updateIntervals(
+  StabbingSession<DataType>& session,
+  const std::string& updatesFile
+)
+{
+  std::ifstream file(updatesFile);
+  if (!file) {
+    throw std::runtime_error("Couldn't open the file " + updatesFile + ".");
+  }
+  std::string line;
+  while (std::getline(file, line)) {
+    const char* p = line.data();
+    const char* const last = p + line.size();
+    while ((p != last) && isBlank(*p)) {
+      ++p;
+    }
+    if (p == last) {
+      continue;
+    }
+    const char update = *p++;
+    bool parsed = false;
+    if (update == '+') {
+      std::pair<DataType, DataType> interval;
+      parsed = parseRecord(p, last, interval);
+      if (parsed) {
+        session.insert(interval);
+      }
+    }
+    else if (update == '-') {
+      size_t index = 0;
+      parsed = parseValue(p, last, index);
+      if (parsed) {
+        session.erase(index);
+      }
+    }
+    if (!parsed) {
+      throw std::runtime_error("Couldn't parse the line \"" + line + "\" in the file " + updatesFile + ".");
+    }
+  }
+}
+
+/**
+ * @brief  Function for printing the boxes stabbed by every batch of D-dimensional points.
+ *
+ * @tparam DataType  Datatype of the box limits and the coordinates of the points.
+ * @tparam D         Number of dimensions.
+ * @param out        Writer to which the results are printed.
+ * @param options    Program options.
+ *
+ * Every line of the intervals file is read as a box, i.e., the lower and the upper limits in every dimension,
+ * and every line of the points files is read as the coordinates of a point.
+ */
+template <typename DataType, unsigned D>
+static
+void
+stabBoxes(
+  ResultWriter& out,
+  const ProgramOptions& options
+)
+{
+  if (options.intervalsFile().empty()) {
+    throw std::runtime_error("No boxes provided. Random generation of boxes hasn't been implemented.");
+  }
+  if (options.pointsFiles().empty()) {
+    throw std::runtime_error("No points provided. Random generation of points hasn't been implemented for boxes.");
+  }
+  Boxes<DataType, D> boxes(options.intervalsFile(), options.numThreads());
+  // Prepare the engine once and stab the boxes with every batch of points.
+  BoxSession<DataType, D> session(boxes, options.engine(), options.deviceNames(), options.sharding(), options.macrosDir(), options.fsmName(), options.cacheDir(), options.maxComparators(), options.maxChunkSize(), options.numThreads());
+  for (const std::string& pointsFile : options.pointsFiles()) {
+    std::vector<std::array<DataType, D> > points(Boxes<DataType, D>::readPoints(pointsFile, options.numThreads()));
+    if (options.mode() == "list") {
+      StabbedIntervals stabbed(session.query(points));
+      ProfiledPhase print("print");
+      size_t written = out.bytes();
+      size_t maxFound = 0;
+      if (out.format() != "text") {
+        for (size_t p = 0; p < points.size(); ++p) {
+          for (const size_t* i = stabbed.begin(p); i != stabbed.end(p); ++i) {
+            out.writeIndices(out.firstQuery() + p, *i);
+          }
+          maxFound = std::max(maxFound, stabbed.size(p));
+        }
+      }
+      else if (stabbed.empty()) {
+        out << "None of the points were found to be stabbing any boxes.\n";
+      }
+      else {
+        out << "Point\tStabbed Boxes\n";
+        for (size_t p = 0; p < points.size(); ++p) {
+          printQuery(out, points[p]);
+          for (const size_t* i = stabbed.begin(p); i != stabbed.end(p); ++i) {
+            out << '\t';
+            if (out.indicesOnly()) {
+              out << *i;
+              continue;
+            }
+            const std::array<std::pair<DataType, DataType>, D>& box = boxes.get(*i);
+            for (unsigned k = 0; k < D; ++k) {
+              out << ((k > 0) ? "x[" : "[") << box[k].first << ',' << box[k].second << ']';
+            }
+          }
+          out << '\n';
+          maxFound = std::max(maxFound, stabbed.size(p));
+        }
+      }
+      out.endBatch(points.size());
+      Profiler::setMaximum("max_stabs_per_query", maxFound);
+      print.addBytes(out.bytes() - written);
+    }
+    else {
+      std::vector<size_t> counts(session.count(points));
+      ProfiledPhase print("print");
+      size_t written = out.bytes();
+      const bool any = (options.mode() == "any");
+      if (out.format() != "text") {
+        for (size_t p = 0; p < points.size(); ++p) {
+          out.writeIndices(out.firstQuery() + p, (any && (counts[p] > 0)) ? 1 : counts[p]);
+        }
+      }
+      else {
+        out << (any ? "Point\tStabbing\n" : "Point\tStabbed Boxes\n");
+        for (size_t p = 0; p < points.size(); ++p) {
+          printQuery(out, points[p]);
+          out << '\t' << ((any && (counts[p] > 0)) ? 1 : counts[p]) << '\n';
+        }
+      }
+      out.endBatch(points.size());
+      if (Profiler::enabled() && !counts.empty()) {
+        Profiler::setMaximum("max_stabs_per_query", *std::max_element(counts.begin(), counts.end()));
+      }
+      print.addBytes(out.bytes() - written);
+    }
+  }
+}
+
+/**
+ * @brief  Function for printing the intervals stabbed by every batch of points.
+ *
+ * @tparam DataType  Datatype of the interval limits and the points.
+ * @param out        Writer to which the results are printed.
  * @param options    Program options.
  */
 template <typename DataType>
 static
 void
 stabIntervals(
+  ResultWriter& out,
   const ProgramOptions& options
 )
 {
+  if (options.numDimensions() == 2) {
+    stabBoxes<DataType, 2>(out, options);
+    return;
+  }
+  if (options.numDimensions() == 3) {
+    stabBoxes<DataType, 3>(out, options);
+    return;
+  }
+  Workload<DataType> workload(options.lengths(), options.meanLength(), options.stabDensity(), options.locations(), options.numClusters(), options.zipfExponent(), options.randomSeed(), options.numThreads());
+  const std::vector<std::string>& pointsFiles = options.pointsFiles();
+
+  // Only convert the inputs to the binary format, if requested.
+  // Random inputs are generated directly to the binary files, without being stored.
+  if (!options.saveIntervalsFile().empty() || !options.savePointsFile().empty()) {
+    if (!options.saveIntervalsFile().empty()) {
+      if (!options.intervalsFile().empty()) {
+        Intervals<DataType>(options.intervalsFile(), options.numThreads()).save(options.saveIntervalsFile());
+      }
+      else if (options.numIntervals() > 0) {
+        workload.saveIntervals(options.saveIntervalsFile(), options.numIntervals());
+      }
+      else {
+        throw std::runtime_error("No intervals provided.");
+      }
+    }
+    if (!options.savePointsFile().empty()) {
+      if (pointsFiles.size() == 1) {
+        Points<DataType>(pointsFiles.front(), options.numThreads()).save(options.savePointsFile());
+      }
+      else if (pointsFiles.empty() && (options.numPoints() > 0)) {
+        workload.savePoints(options.savePointsFile(), options.numPoints());
+      }
+      else {
+        throw std::runtime_error("Exactly one batch of points should be provided for saving.");
+      }
+    }
+    return;
+  }
+
   Intervals<DataType> intervals;
   // Read intervals from the file, if one is provided.
   // Otherwise, generate random intervals.
-  std::default_random_engine generator(options.randomSeed());
   if (!options.intervalsFile().empty()) {
-    intervals = Intervals<DataType>(options.intervalsFile());
+    intervals = Intervals<DataType>(options.intervalsFile(), options.numThreads());
   }
   else if (options.numIntervals() > 0) {
-    intervals = Intervals<DataType>(options.numIntervals(), generator);
+    intervals = workload.intervals(options.numIntervals());
   }
   else {
     throw std::runtime_error("No intervals provided.");
   }
-  Points<DataType> points;
-  // Read points from the file, if one is provided.
-  // Otherwise, generate random points.
-  if (!options.pointsFile().empty()) {
-    points = Points<DataType>(options.pointsFile());
+
+  const std::vector<std::string>& queriesFiles = options.queriesFiles();
+  if (pointsFiles.empty() && (options.numPoints() == 0) && queriesFiles.empty()) {
+    throw std::runtime_error("No points provided.");
   }
-  else if (options.numPoints() > 0) {
-    points = Points<DataType>(options.numPoints(), generator);
+  // Prepare the engine once and stab the intervals with every batch of points.
+  StabbingSession<DataType> session(intervals, options.engine(), options.deviceNames(), options.sharding(), options.macrosDir(), options.fsmName(), options.cacheDir(), options.maxComparators(), options.numSpares(), options.maxChunkSize(), options.numThreads());
+  if (!options.updatesFile().empty()) {
+    updateIntervals(session, options.updatesFile());
   }
-  else {
-    throw std::runtime_error("No points provided.");
+  // Read points from the files, if any are provided.
+  // Otherwise, generate random points.
+  if (pointsFiles.empty() && (options.numPoints() > 0)) {
+    Points<DataType> points(workload.points(options.numPoints()));
+    stabBatch(out, session, points, options.mode());
   }
-  std::unordered_map<size_t, std::vector<size_t> > stabs = intervals.stab(points, options.deviceName(), options.macrosDir(), options.fsmName(), options.maxChunkSize());
-
-  // Print the stabbed intervals.
-  if (stabs.empty()) {
-    std::cout << "None of the points were found to be stabbing any intervals." << std::endl;
+  for (const std::string& pointsFile : pointsFiles) {
+    Points<DataType> points(pointsFile, options.numThreads());
+    stabBatch(out, session, points, options.mode());
   }
-  else {
-    std::cout << "Point\tStabbed Intervals" << std::endl;
-    for (size_t p = 0; p < points.count(); ++p) {
-      std::cout << points.get(p);
-      if (stabs.find(p) != stabs.end()) {
-        for (const size_t& i : stabs[p]) {
-          const std::pair<DataType, DataType>& interval = intervals.get(i);
-          std::cout << "\t[" << interval.first << "," << interval.second << "]";
-        }
-      }
-      std::cout << std::endl;
-    }
+  // Check the intervals for overlaps with every batch of query intervals.
+  for (const std::string& queriesFile : queriesFiles) {
+    Intervals<DataType> queries(Intervals<DataType>::readQueries(queriesFile, options.numThreads()));
+    overlapBatch(out, session, queries, options.mode());
   }
 }
 
@@ -106,13 +537,17 @@ main(
     return 1;
   }
 
+  if (!options.profileFile().empty()) {
+    Profiler::enable();
+  }
   try {
+    ResultWriter results(options.outputFile(), options.format(), options.indicesOnly());
     if (options.isReal()) {
       if (options.numBytes() == 4) {
-        stabIntervals<float>(options);
+        stabIntervals<float>(results, options);
       }
       else if (options.numBytes() == 8) {
-        stabIntervals<double>(options);
+        stabIntervals<double>(results, options);
       }
       else {
         throw std::runtime_error("Unsupported number of bytes.");
@@ -120,10 +555,10 @@ main(
     }
     else if (options.isSigned()) {
       if (options.numBytes() == 4) {
-        stabIntervals<int32_t>(options);
+        stabIntervals<int32_t>(results, options);
       }
       else if (options.numBytes() == 8) {
-        stabIntervals<int64_t>(options);
+        stabIntervals<int64_t>(results, options);
       }
       else {
         throw std::runtime_error("Unsupported number of bytes.");
@@ -131,15 +566,19 @@ main(
     }
     else {
       if (options.numBytes() == 4) {
-        stabIntervals<uint32_t>(options);
+        stabIntervals<uint32_t>(results, options);
       }
       else if (options.numBytes() == 8) {
-        stabIntervals<uint64_t>(options);
+        stabIntervals<uint64_t>(results, options);
       }
       else {
         throw std::runtime_error("Unsupported number of bytes.");
       }
     }
+    results.flush();
+    if (Profiler::enabled()) {
+      Profiler::write(options.profileFile());
+    }
   }
   catch (std::runtime_error& re) {
     std::cerr << re.what() << std::endl;